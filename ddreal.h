@@ -0,0 +1,167 @@
+/******************************************************************************/
+
+/* double-double arithmetic: an unevaluated sum (hi + lo), |lo| <= ulp(hi)/2,
+ * with a precision of ~106 bits. used for error analysis in place of the
+ * (software) binary128 '__float128' type, where it is much faster. */
+
+/* [4] T.J. Dekker, "A Floating-Point Technique for Extending the Available
+ * Precision". Numerische Mathematik, Vol. 18, 1971, pp. 224-242. */
+
+/* [5] Y. Hida, X.S. Li, D.H. Bailey, "Library for Double-Double and Quad-
+ * Double Arithmetic". (the QD library), 2007. */
+
+/* Copyright (c) 2020 Brett Hale.
+ * distributed under BSD-2-Clause license terms. see: mrtab.c */
+
+/******************************************************************************/
+
+#ifndef DD_REAL_H_
+#define DD_REAL_H_
+
+#include <math.h>
+
+/* note: these algorithms require round-to-nearest binary64 arithmetic,
+ * with no extended precision for intermediate values; i.e., SSE2 rather
+ * than x87, and no '-ffast-math' or similar value-unsafe options. */
+
+typedef struct ddreal
+{
+    double hi, lo;
+}
+ddreal;
+
+/******************************************************************************/
+
+static inline ddreal dd_two_sum (double a, double b) /* (Knuth) 2Sum */
+{
+    ddreal r;
+    double t;
+
+    r.hi = a + b, t = r.hi - a;
+    r.lo = (a - (r.hi - t)) + (b - t);
+
+    return r;
+}
+
+static inline ddreal dd_fast_two_sum (double a, double b) /* |a| >= |b| */
+{
+    ddreal r;
+
+    r.hi = a + b, r.lo = b - (r.hi - a);
+
+    return r;
+}
+
+
+static inline ddreal dd_two_prod (double a, double b) /* 2Prod */
+{
+    ddreal r;
+
+    r.hi = a * b;
+
+#if defined (FP_FAST_FMA)
+    r.lo = fma(a, b, - r.hi);
+#else
+    {
+        /* Dekker split: (a = ah + al), (b = bh + bl) : */
+
+        const double c = 134217729.0; /* (2^27 + 1) */
+        double ah, al, bh, bl, t;
+
+        t = c * a, ah = t - (t - a), al = a - ah;
+        t = c * b, bh = t - (t - b), bl = b - bh;
+
+        r.lo = ((ah * bh - r.hi) + ah * bl + al * bh) + al * bl;
+    }
+#endif
+
+    return r;
+}
+
+/******************************************************************************/
+
+static inline ddreal dd_from (double a)
+{
+    ddreal r = {a, 0.0};
+    return r;
+}
+
+static inline double dd_to (ddreal a)
+{
+    return a.hi + a.lo;
+}
+
+
+static inline ddreal dd_add (ddreal a, ddreal b) /* (QD 'ieee_add') */
+{
+    ddreal s = dd_two_sum(a.hi, b.hi), t = dd_two_sum(a.lo, b.lo);
+
+    s.lo += t.hi;
+    s = dd_fast_two_sum(s.hi, s.lo);
+    s.lo += t.lo;
+
+    return dd_fast_two_sum(s.hi, s.lo);
+}
+
+static inline ddreal dd_add_d (ddreal a, double b)
+{
+    ddreal s = dd_two_sum(a.hi, b);
+
+    s.lo += a.lo;
+
+    return dd_fast_two_sum(s.hi, s.lo);
+}
+
+static inline ddreal dd_sub (ddreal a, ddreal b)
+{
+    b.hi = - b.hi, b.lo = - b.lo;
+    return dd_add(a, b);
+}
+
+
+static inline ddreal dd_mul (ddreal a, ddreal b)
+{
+    ddreal p = dd_two_prod(a.hi, b.hi);
+
+    p.lo += a.hi * b.lo + a.lo * b.hi;
+
+    return dd_fast_two_sum(p.hi, p.lo);
+}
+
+static inline ddreal dd_mul_d (ddreal a, double b)
+{
+    ddreal p = dd_two_prod(a.hi, b);
+
+    p.lo += a.lo * b;
+
+    return dd_fast_two_sum(p.hi, p.lo);
+}
+
+
+/* a / b : long division, with a correction for the remainder: */
+
+static inline ddreal dd_div (ddreal a, ddreal b)
+{
+    double q1, q2, q3;
+    ddreal r;
+
+    q1 = a.hi / b.hi;
+    r = dd_sub(a, dd_mul_d(b, q1));
+
+    q2 = r.hi / b.hi;
+    r = dd_sub(r, dd_mul_d(b, q2));
+
+    q3 = r.hi / b.hi;
+
+    r = dd_fast_two_sum(q1, q2);
+    return dd_add_d(r, q3);
+}
+
+static inline ddreal dd_div_d (double a, double b) /* a / b : */
+{
+    return dd_div(dd_from(a), dd_from(b));
+}
+
+/******************************************************************************/
+
+#endif /* DD_REAL_H_ */
@@ -1,36 +1,218 @@
 /******************************************************************************/
 
-/* DLP.4.proposition.2 : test k-bit prime probability bounds: */
+/* DLP.4.proposition.2 : test k-bit prime probability bounds, with the
+ * exact k-bit prime counts: pi(2^k) - pi(2^(k - 1)), for k <= 44. */
+
+/* the sieve is multi-threaded if built with OpenMP support, e.g.,
+ * 'cc -O2 -fopenmp'. (k = 40) is a ~(2^39) odd value sieve, which takes
+ * ~(40) minutes on a single core. */
 
 /* Copyright (c) 2020 Brett Hale.
  * distributed under BSD-2-Clause license terms. see: mrtab.c */
 
 /******************************************************************************/
 
+/* a segmented sieve of Eratosthenes over the odd values, as in spsp2.c.
+ * the segments are aligned, so for (k > 21) each segment lies within a
+ * single k-bit range, and is counted as a whole. the counts are written
+ * as the 'dlp_pi_lut' initializer used by mrtab. */
+
+/******************************************************************************/
+
 #include <inttypes.h>
+#include <stdlib.h>
 #include <stdio.h>
 
+#include <math.h>
+
+#if defined (_OPENMP)
+#include <omp.h>
+#endif
 
-int main (void)
+
+/* return (1) if the nul-terminated C string forms a valid
+ * 32-bit unsigned integer value in C locale decimal format,
+ * and store the value in (u); return (0) otherwise: */
+
+static int u32_arg (unsigned long *u, const char *s)
 {
-    for (unsigned int k = 4; k <= (20); k++)
+    int ret;
+
+    if ((ret = *s) != 0)
     {
-        uint32_t nmax = (UINT32_C(1) << k), n, p;
+        unsigned long x = 0, d;
 
-        for (p = 0, n = (nmax >> 1) + 1; n < nmax; n += 2)
+        if (ret == '0') /* "0" or not a decimal format: */
+            return (s[1] ? (0) : (*u = x) == 0);
+
+        for (; (d = (unsigned long) (*s++)) != 0; x += d)
         {
-            uint32_t d, q, c = 0;
+            if ((d -= ('0')) > (9) ||
+                (x > (0xffffffffUL / (10)))) return (0);
+            if ((x *= (10)) > (0xffffffffUL - d))
+                return (0);
+        }
+
+        *u = x; /* a valid 32-bit unsigned integer value. */
+    }
+
+    return ret;
+}
+
+/******************************************************************************/
+
+#define SEG_ODDS (UINT32_C(1) << 20) /* odd values per segment. */
+
+/* sieve the segments {b0 .. b1 - 1} of odd values, adding the number of
+ * primes with (k) significant bits to pk[k] : */
+
+static void pi_range (uint64_t *pk, uint64_t b0, uint64_t b1,
+                      const uint32_t *sp, uint32_t np)
+{
+    uint64_t *nx = malloc(np * sizeof(uint64_t));
+    uint8_t *c = malloc(SEG_ODDS);
+    uint32_t i;
+
+    if (nx == NULL || c == NULL)
+        abort();
+
+    for (i = 0; i < np; i++) /* first odd multiple (>= p^2) : */
+    {
+        uint64_t p = sp[i], lo = b0 * SEG_ODDS * 2 + 1, m;
+
+        if ((m = (lo + p - 1) / p) < p)
+            m = p;
+        nx[i] = p * (m | 0x1);
+    }
+
+    for (uint64_t b = b0; b < b1; b++)
+    {
+        uint64_t lo = b * SEG_ODDS * 2 + 1, hi = lo + SEG_ODDS * 2, n, cnt;
+
+        for (n = 0; n < SEG_ODDS; n++) c[n] = 1;
+
+        for (i = 0; i < np; i++)
+        {
+            uint64_t x = nx[i], d = 2 * (uint64_t) sp[i];
+
+            for (; x < hi; x += d)
+                c[(x - lo) >> 1] = 0;
+
+            nx[i] = x;
+        }
+
+        if (b == 0) /* (mixed k values) */
+        {
+            for (c[0] = 0, pk[2]++, n = 1; n < SEG_ODDS; n++)
+            {
+                unsigned int k = 0;
+                for (uint64_t x = lo + 2 * n; x != 0; x >>= 1) k++;
+                pk[k] += c[n];
+            }
+
+            continue;
+        }
 
-            for (d = 3; !c && (q = n / d) >= d; d += 2)
-                c = (q * d == n);
+        for (cnt = 0, n = 0; n < SEG_ODDS; n++)
+            cnt += c[n];
 
-            p += (c == 0); /* (n) is prime. */
+        for (n = lo, i = 0; n != 0; n >>= 1) i++;
+        pk[i] += cnt;
+    }
+
+    free(c), free(nx);
+}
+
+/******************************************************************************/
+
+int main (int argc, char **argv)
+{
+    uint32_t k = (32), pmax, np, i, *sp;
+    uint64_t nmax, nblk, pk[(64)] = {0};
+    uint8_t *c;
+
+    if (argc > 1) /* (k) option: */
+    {
+        unsigned long u;
+
+        if (!u32_arg(& u, argv[1]) || (u < 22) || (u > 44))
+        {
+            fprintf(stderr, "usage: dlpp2 [k], where: "
+                    "k = 22 .. 44 (default: 32)\n");
+            return (1);
         }
 
-        double lhs = (double) p * k, rhs = 0.71867 * nmax;
-        fprintf(stdout, "%2u : %s\n", k, ((lhs > rhs) ? "T" : "F"));
+        k = (uint32_t) u;
     }
 
+    nmax = (UINT64_C(1) << k);
+    pmax = (UINT32_C(1) << ((k + 1) / 2)); /* p < sqrt(nmax) */
+
+    /* odd primes < pmax (sieve of Eratosthenes) : */
+
+    c = calloc(pmax, 1), sp = malloc(pmax / 2 * sizeof(uint32_t));
+
+    if (c == NULL || sp == NULL)
+        return (1);
+
+    for (np = 0, i = 3; i < pmax; i += 2)
+    {
+        if (c[i] != 0) /* composite: */
+            continue;
+
+        for (uint64_t j = (uint64_t) i * i; j < pmax; j += 2 * i)
+            c[j] = 1;
+
+        sp[np++] = i;
+    }
+
+    free(c);
+
+    nblk = nmax / 2 / SEG_ODDS;
+
+#if defined (_OPENMP)
+#pragma omp parallel
+#endif
+    {
+        uint64_t tk[(64)] = {0}, b0, b1;
+        unsigned int tid = 0, nth = 1, j;
+
+#if defined (_OPENMP)
+        tid = (unsigned int) omp_get_thread_num();
+        nth = (unsigned int) omp_get_num_threads();
+#endif
+
+        b0 = nblk * tid / nth, b1 = nblk * (tid + 1) / nth;
+        pi_range(tk, b0, b1, sp, np);
+
+#if defined (_OPENMP)
+#pragma omp critical
+#endif
+        for (j = 0; j < (64); j++)
+            pk[j] += tk[j];
+    }
+
+    free(sp);
+
+    /* DLP.4.proposition.2 : (pk * k > 0.71867 * 2^k) ? */
+
+    for (i = 4; i <= k; i++)
+    {
+        double lhs = (double) pk[i] * i, rhs = 0.71867 * exp2(i);
+
+        fprintf(stdout, "%2"PRIu32" : %12"PRIu64" : %s\n", i, pk[i],
+                ((lhs > rhs) ? "T" : "F"));
+    }
+
+    fprintf(stdout, "\nstatic const uint64_t dlp_pi_lut[%"PRIu32"] =\n{",
+            k + 1);
+
+    for (i = 0; i <= k; i++)
+        fprintf(stdout, "%s%"PRIu64, (i == 0) ? "\n    " : (i % 4) ?
+                ", " : ",\n    ", pk[i]);
+
+    fprintf(stdout, "\n};\n");
+
     return (0);
 }
 
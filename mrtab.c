@@ -40,7 +40,8 @@
  * pi(2^k) - pi(2^(k - 1)) > (0.71867) * (2^k) / k, for all k >= 21.
 
  * by counting the primes < (2^20), it is clear that this lower bound is
- * actually valid for all k >= 8. */
+ * actually valid for all k >= 8. the exact counts, for k <= DLP_PI_K,
+ * are used instead (see: dlpp2.c); the bound for larger (k). */
 
 
 /* [2] R. Burthe, Jr., "Further Investigations with the Strong Probable
@@ -62,6 +63,7 @@
 
 #include <string.h>
 #include <stdio.h>
+#include <time.h>
 
 #include <float.h>
 #include <math.h>
@@ -70,6 +72,10 @@
 #define M_PI (3.14159265358979323846264338327950288)
 #endif
 
+#ifndef M_LN2
+#define M_LN2 (0.69314718055994530941723212145817657)
+#endif
+
 
 /* return (1) if the nul-terminated C string forms a valid
  * 32-bit unsigned integer value in C locale decimal format,
@@ -102,17 +108,68 @@ static int u32_arg (unsigned long *u, const char *s)
 
 /******************************************************************************/
 
-/* the signature for the p(k, t) evaluation function: */
+/* the signature for the p(k, t) evaluation function, which returns the
+ * log-domain value: lb(p(k, t)), as (2^-s) is not a normal double value
+ * for (s > 1022), and the intermediate terms underflow well before that.
+ * (lb) denotes the binary logarithm, as in [DLP]. */
 
 /* note: an implementation may assert that: (k > 16 && t >= 1), although
  * it should attempt to handle all (k > 1). the values of (k <= 1) yield:
  * p(k, t) = (1) (no primes), while (t = 0) is meaningless. */
 
-typedef double (*p_kt_fn)(unsigned int, unsigned int);
+typedef double (*lp_kt_fn)(unsigned int, unsigned int);
+
+/* the signature for the vector evaluation function, which stores:
+ * lb(p(k[i], t)) in lp[i], for each of the (MRTAB_LANES) lanes. the (k)
+ * values are arbitrary, but are typically consecutive. */
+
+#ifndef MRTAB_LANES
+#define MRTAB_LANES (8) /* (4, 8, or 16) */
+#endif
+
+typedef void (*lp_kt_vfn)(const unsigned int *, unsigned int, double *);
+
+
+/* instrumentation: the number of (k, t) evaluations (counting each vector
+ * lane), and the 'M' candidate that achieved the minimum in the previous
+ * scalar DLP.4 evaluation, or (0) if the (4^-t) [RBJ] or Monier-Rabin
+ * bound was not improved upon: */
+
+static unsigned long lp_kt_evals;
+static unsigned int dlp_mopt;
+
+
+/* return lb(2^x + 2^y), where (x, y) may be: -HUGE_VAL (i.e., lb(0)) : */
+
+static double lb_add (double x, double y)
+{
+    if (x < y) /* ensure: x >= y */
+    {
+        double t = x;
+        x = y, y = t;
+    }
+
+    if (y == - HUGE_VAL)
+        return x;
+
+    return x + log1p(exp2(y - x)) / M_LN2;
+}
+
+/******************************************************************************/
 
-static int dlp_tab (p_kt_fn p_kt)
+static int dlp_tab (lp_kt_vfn lp_kt_v)
 {
-    unsigned int k, t;
+    unsigned int kv[(16)], k, t, i;
+    double lv[(10) + 1][(16)];
+
+    /* (11) rows, padded to (16) lanes: */
+
+    for (i = 0; i < (16); i++)
+        kv[i] = 100 + 50 * ((i < 11) ? i : 10);
+
+    for (t = 1; t <= 10; t++)
+        for (i = 0; i < (16); i += MRTAB_LANES)
+            (*lp_kt_v)(kv + i, t, lv[t] + i);
 
     fprintf(stdout, "lower bounds for -lb(p(k, t))\n\n");
     /* DLP.table.1 actually lists: floor(-lb(p(k, t))) */
@@ -125,40 +182,317 @@ static int dlp_tab (p_kt_fn p_kt)
         fprintf(stdout, "----");
     fprintf(stdout, "\n");
 
-    for (k = 100; k <= 600; k += 50)
+    for (i = 0; i < 11; i++)
     {
-        fprintf(stdout, "%3u |", k);
+        fprintf(stdout, "%3u |", (k = kv[i]));
         for (t = 1; t <= 10; t++)
             fprintf(stdout, " %3u", /* floor(-lb(p(k, t))) : */
-                    (unsigned int) (- log2((*p_kt)(k, t))));
+                    (unsigned int) (- lv[t][i]));
         fprintf(stdout, "\n");
     }
 
     return (0);
 }
 
+/* p(k, t) for a single (k), and t = 1 .. 16, in the format read by the
+ * mcpkt utility (see: xperimental/mcpkt.c) : */
+
+static int pkt_tab (lp_kt_fn lp_kt, unsigned int k, int inc)
+{
+    unsigned int t;
+
+    fprintf(stdout, "%c(k, t) for k = %u :\n", inc ? 'q' : 'p', k);
+
+    for (t = 1; t <= 16; t++)
+    {
+        double lp = (*lp_kt)(k, t);
+        fprintf(stdout, "t = %2u : %.6e (2^%.2f)\n", t, exp2(lp), lp);
+    }
+
+    return (0);
+}
+
 
-/* RBJ.4 : exact p(k, 1) values for 2 <= k <= 24 (Monier's result) : */
+/* RBJ.4 : exact p(k, t) values for 2 <= k <= RBJ4_K, 1 <= t <= 10, using
+ * Monier's result for S(n). generated by the rbj4 utility (k <= 24), and
+ * the rbj4s utility (k > 24) : */
 
-/* since p(k, 1) < 1/5 for 2 <= k <= 24, the Monier-Rabin theorem yields:
- * p(k, t) <= 4^(1-t) * p(k, 1) / (1 - p(k, 1)) < (4^-t). */
+#define RBJ4_K (34)
 
-static const double p_k1_lut[25] = /* exact p(0, 1) .. p(24, 1) : */
+static const double p_kt_lut[RBJ4_K + 1][10] = /* exact p(k, t) : */
 {
-    1.0000000000000000e+00, 1.0000000000000000e+00, 0.0000000000000000e+00,
-    0.0000000000000000e+00, 1.6417910447761200e-01, 6.4299424184261059e-02,
-    6.5348064836078495e-02, 5.6654752251003040e-02, 3.8003778178391873e-02,
-    3.0837119635400381e-02, 2.0525079764265652e-02, 1.7393574680619316e-02,
-    1.0710359182783314e-02, 7.9490871698650184e-03, 5.9337043808932611e-03,
-    3.9442643069209568e-03, 2.6255166117476652e-03, 1.9286518790611249e-03,
-    1.2577894174913744e-03, 9.0457147250914852e-04, 6.0885312016630043e-04,
-    4.0170629568174411e-04, 2.7576379216948154e-04, 1.8760654682551843e-04,
-    1.2612847365349537e-04
+    { /* k = 0 : */
+        1.0000000000000000e+00, 1.0000000000000000e+00, 1.0000000000000000e+00,
+        1.0000000000000000e+00, 1.0000000000000000e+00, 1.0000000000000000e+00,
+        1.0000000000000000e+00, 1.0000000000000000e+00, 1.0000000000000000e+00,
+        1.0000000000000000e+00
+    },
+    { /* k = 1 : */
+        1.0000000000000000e+00, 1.0000000000000000e+00, 1.0000000000000000e+00,
+        1.0000000000000000e+00, 1.0000000000000000e+00, 1.0000000000000000e+00,
+        1.0000000000000000e+00, 1.0000000000000000e+00, 1.0000000000000000e+00,
+        1.0000000000000000e+00
+    },
+    { /* k = 2 : */
+        0.0000000000000000e+00, 0.0000000000000000e+00, 0.0000000000000000e+00,
+        0.0000000000000000e+00, 0.0000000000000000e+00, 0.0000000000000000e+00,
+        0.0000000000000000e+00, 0.0000000000000000e+00, 0.0000000000000000e+00,
+        0.0000000000000000e+00
+    },
+    { /* k = 3 : */
+        0.0000000000000000e+00, 0.0000000000000000e+00, 0.0000000000000000e+00,
+        0.0000000000000000e+00, 0.0000000000000000e+00, 0.0000000000000000e+00,
+        0.0000000000000000e+00, 0.0000000000000000e+00, 0.0000000000000000e+00,
+        0.0000000000000000e+00
+    },
+    { /* k = 4 : */
+        1.6417910447761200e-01, 3.9804041641151283e-02, 9.1850781972873663e-03,
+        2.1567101120239262e-03, 5.1776254221030851e-04, 1.2630428758793609e-04,
+        3.1123742246969535e-05, 7.7160682558600115e-06, 1.9197354135326194e-06,
+        4.7860699572568195e-07
+    },
+    { /* k = 5 : */
+        6.4299424184261059e-02, 8.6632792193402607e-03, 1.2154799635867883e-03,
+        1.8129067132029359e-04, 2.8258024219241456e-05, 4.5281088398530167e-06,
+        7.3763579913476536e-07, 1.2132000038244951e-07, 2.0064665541987945e-08,
+        3.3290850895069706e-09
+    },
+    { /* k = 6 : */
+        6.5348064836078495e-02, 4.7085095503592370e-03, 4.0475636750010097e-04,
+        4.1493429707957006e-05, 4.7197739190554934e-06, 5.6509767296267012e-07,
+        6.9269851242295018e-08, 8.5816922277347553e-09, 1.0682882845183800e-09,
+        1.3327839940189947e-10
+    },
+    { /* k = 7 : */
+        5.6654752251003040e-02, 5.2441420398603271e-03, 7.6507698962178985e-04,
+        1.3507535200537609e-04, 2.5633479336741465e-05, 5.0115130812682356e-06,
+        9.9239426068081242e-07, 1.9761327983184961e-07, 3.9446283749363632e-08,
+        7.8824657882418893e-09
+    },
+    { /* k = 8 : */
+        3.8003778178391873e-02, 2.0508261185649495e-03, 1.8218120022754327e-04,
+        1.9985333843235668e-05, 2.4146579632731753e-06, 3.0725678853984693e-07,
+        4.0262748597508767e-08, 5.3657265027987966e-09, 7.2204938794250152e-10,
+        9.7708181274012969e-11
+    },
+    { /* k = 9 : */
+        3.0837119635400381e-02, 1.7680910590137037e-03, 1.7113272850855215e-04,
+        1.9888458932535776e-05, 2.5125715271989829e-06, 3.3209926350096815e-07,
+        4.5123444127766624e-08, 6.2468213921975434e-09, 8.7670010366955188e-10,
+        1.2432854959589761e-10
+    },
+    { /* k = 10 : */
+        2.0525079764265652e-02, 1.1675940207767361e-03, 1.8526119203080685e-04,
+        3.9048446707993664e-05, 8.8045131561474634e-06, 2.0189524680439119e-06,
+        4.6506668804046798e-07, 1.0726581803326436e-07, 2.4749703103584640e-08,
+        5.7111947233378578e-09
+    },
+    { /* k = 11 : */
+        1.7393574680619316e-02, 1.0993382174516871e-03, 1.6597201219839213e-04,
+        3.1760161277051888e-05, 6.6966097357782046e-06, 1.4853800596911465e-06,
+        3.3904681933247992e-07, 7.8688148703148589e-08, 1.8443083795404557e-08,
+        4.3483874065535259e-09
+    },
+    { /* k = 12 : */
+        1.0710359182783314e-02, 4.2584472112786091e-04, 4.3505805020542785e-05,
+        5.9447905414995145e-06, 9.2108189003277913e-07, 1.5219522603470754e-07,
+        2.6049911952374838e-08, 4.5488985604594712e-09, 8.0368404841969430e-10,
+        1.4298875399810610e-10
+    },
+    { /* k = 13 : */
+        7.9490871698650184e-03, 2.9678564775513375e-04, 2.8257463356946030e-05,
+        3.6242558260250296e-06, 5.2731217863677358e-07, 8.1155611577134707e-08,
+        1.2814270790540745e-08, 2.0478560381925042e-09, 3.2919224673551054e-10,
+        5.3073618689411179e-11
+    },
+    { /* k = 14 : */
+        5.9337043808932611e-03, 3.3243679310006942e-04, 4.8206470939102140e-05,
+        8.7980658886446560e-06, 1.7783597651481393e-06, 3.8098217881432469e-07,
+        8.4714946589332613e-08, 1.9321215954048023e-08, 4.4863900511383054e-09,
+        1.0553604102212172e-09
+    },
+    { /* k = 15 : */
+        3.9442643069209568e-03, 1.4134271181940965e-04, 1.3595254447449821e-05,
+        1.7003783752667642e-06, 2.3696602339582110e-07, 3.4894675479197238e-08,
+        5.3060608249928875e-09, 8.2353864541938884e-10, 1.2961552461678215e-10,
+        2.0604263287266088e-11
+    },
+    { /* k = 16 : */
+        2.6255166117476652e-03, 1.0274951511347716e-04, 1.2800207596421544e-05,
+        2.2353771360545268e-06, 4.5351911526985910e-07, 9.9276714493302636e-08,
+        2.2667153461623218e-08, 5.3081979548442382e-09, 1.2634665904203884e-09,
+        3.0404694886973628e-10
+    },
+    { /* k = 17 : */
+        1.9286518790611249e-03, 8.6476310457765090e-05, 1.1996141408531116e-05,
+        2.2186387929125966e-06, 4.6324291622382094e-07, 1.0307401758200688e-07,
+        2.3808197927337862e-08, 5.6297586804184038e-09, 1.3517418489995632e-09,
+        3.2789350478118441e-10
+    },
+    { /* k = 18 : */
+        1.2577894174913744e-03, 5.7378510392064826e-05, 8.4137898162364562e-06,
+        1.6074744852693611e-06, 3.4368673296919636e-07, 7.7974734436831709e-08,
+        1.8307383148401012e-08, 4.3887060019298961e-09, 1.0658738248770941e-09,
+        2.6102761986406644e-10
+    },
+    { /* k = 19 : */
+        9.0457147250914852e-04, 4.0097866377175804e-05, 5.5869572299034832e-06,
+        1.0558931397070645e-06, 2.2775748863872329e-07, 5.2430503229834646e-08,
+        1.2488481058550276e-08, 3.0306362173184189e-09, 7.4324010272772820e-10,
+        1.8338927948900951e-10
+    },
+    { /* k = 20 : */
+        6.0885312016630043e-04, 2.8146951803828273e-05, 4.0948525101219120e-06,
+        7.7345320085774066e-07, 1.6282258716605902e-07, 3.6305863923292972e-08,
+        8.3822119045471590e-09, 1.9794375970589296e-09, 4.7456971917960882e-10,
+        1.1496062528631117e-10
+    },
+    { /* k = 21 : */
+        4.0170629568174411e-04, 1.6502224708437708e-05, 2.1725461601246186e-06,
+        3.8170564101628708e-07, 7.6783456598028058e-08, 1.6662703546992731e-08,
+        3.7843208336044182e-09, 8.8431783018096215e-10, 2.1050059005326124e-10,
+        5.0728853594087002e-11
+    },
+    { /* k = 22 : */
+        2.7576379216948154e-04, 1.0947914435305879e-05, 1.3420763369202574e-06,
+        2.1872428112286777e-07, 4.0978013436185697e-08, 8.3720563423002532e-09,
+        1.8148047877597073e-09, 4.1015010691850158e-10, 9.5472810179154539e-11,
+        2.2691833939009902e-11
+    },
+    { /* k = 23 : */
+        1.8760654682551843e-04, 7.7984609140221205e-06, 1.0140490495411049e-06,
+        1.7760258384797035e-07, 3.5848941720386450e-08, 7.8321123039382860e-09,
+        1.7937334621249576e-09, 4.2294917844323098e-10, 1.0158572646786086e-10,
+        2.4691803761797790e-11
+    },
+    { /* k = 24 : */
+        1.2612847365349537e-04, 5.4523392673794705e-06, 7.5938888636276993e-07,
+        1.4106709326261253e-07, 2.9719449802898054e-08, 6.6876113686705329e-09,
+        1.5626351380835381e-09, 3.7349791423390535e-10, 9.0542811021271898e-11,
+        2.2148482208693993e-11
+    },
+    { /* k = 25 : */
+        8.2745077428764810e-05, 3.3352429440708350e-06, 4.4924370018780986e-07,
+        8.1607685109773267e-08, 1.6912939565441024e-08, 3.7605131369107941e-09,
+        8.7126995160682503e-10, 2.0706273818095349e-10, 5.0017264360208971e-11,
+        1.2211786579045266e-11
+    },
+    { /* k = 26 : */
+        5.7520872410324346e-05, 2.5797444624993591e-06, 3.6314104042698806e-07,
+        6.7498836168039546e-08, 1.4191590341897334e-08, 3.1850827165396686e-09,
+        7.4247064392849960e-10, 1.7716435667333093e-10, 4.2910355640650139e-11,
+        1.0495704465002177e-11
+    },
+    { /* k = 27 : */
+        3.7816992597174767e-05, 1.6291895413762754e-06, 2.2247164066984011e-07,
+        4.0013063217322918e-08, 8.1840421769962619e-09, 1.7999174956984391e-09,
+        4.1371087871578975e-10, 9.7779559605755796e-11, 2.3530986520620316e-11,
+        5.7305913148138044e-12
+    },
+    { /* k = 28 : */
+        2.6108672185562469e-05, 1.1671182698436898e-06, 1.5867068720980004e-07,
+        2.8319884608244520e-08, 5.7436711396279213e-09, 1.2525282306651899e-09,
+        2.8567498462764566e-10, 6.7078758325263892e-11, 1.6058445495920896e-11,
+        3.8950106027453684e-12
+    },
+    { /* k = 29 : */
+        1.7354542509997250e-05, 7.5287228552489612e-07, 1.0113993630840498e-07,
+        1.8037154282023667e-08, 3.6680859281595576e-09, 8.0266777324860893e-10,
+        1.8368257853139601e-10, 4.3256548784583052e-11, 1.0380734142507832e-11,
+        2.5227924460396327e-12
+    },
+    { /* k = 30 : */
+        1.1677600213327582e-05, 5.1954838816890053e-07, 7.0459847297117728e-08,
+        1.2543474660056998e-08, 2.5390728440429100e-09, 5.5345859443397118e-10,
+        1.2634559505601109e-10, 2.9717194925426008e-11, 7.1284799743722761e-12,
+        1.7324989395010302e-12
+    },
+    { /* k = 31 : */
+        7.9901929975812680e-06, 3.7040075353569377e-07, 5.1935255968158401e-08,
+        9.5381058905946469e-09, 1.9790407869098028e-09, 4.3907868541793640e-10,
+        1.0143626315385448e-10, 2.4044522567879609e-11, 5.7965313226033610e-12,
+        1.4132604008711884e-12
+    },
+    { /* k = 32 : */
+        5.2477865950467399e-06, 2.2832652334830420e-07, 3.0580287049879456e-08,
+        5.4638312044965225e-09, 1.1149617345328874e-09, 2.4477654154087856e-10,
+        5.6155559122936072e-11, 1.3248039062943357e-11, 3.1832475889268450e-12,
+        7.7431412942007456e-13
+    },
+    { /* k = 33 : */
+        3.6179749951271561e-06, 1.6824557678556809e-07, 2.3216155920921561e-08,
+        4.1985780638233382e-09, 8.6081245377544495e-10, 1.8935940166515862e-10,
+        4.3487889640639422e-11, 1.0266751579642587e-11, 2.4682325157582601e-12,
+        6.0064913229547821e-13
+    },
+    { /* k = 34 : */
+        2.4225310857839795e-06, 1.1001789881413936e-07, 1.4754959658399023e-08,
+        2.6087883323906593e-09, 5.2574344404905448e-10, 1.1417567508611371e-10,
+        2.5977215659091824e-11, 6.0921250916681375e-12, 1.4578323631833017e-12,
+        3.5363817691087163e-13
+    }
 };
 
+
+/* since S(n) / (n - 1) <= 1/4 for all odd composites (n), the sum over
+ * the k-bit odd composites: A(t) = sum{(S(n) / (n - 1))^t} satisfies:
+ * A(t) <= 4^(10 - t) * A(10), and with p = p(k, 10), for t > 10 :
+
+ * p(k, t) <= r / (1 + r), where: r = 4^(10 - t) * p / (1 - p).
+
+ * this is the Monier-Rabin argument, applied to p(k, 10) rather than to
+ * p(k, 1). return: lb(p(k, t)), for k <= RBJ4_K : */
+
+static double mr_lkt (unsigned int k, unsigned int t)
+{
+    double p = p_kt_lut[k][((t < 10) ? t : 10) - 1], lr;
+
+    if (t <= 10 || p == 0.0 || p == 1.0)
+        return log2(p);
+
+    lr = 2.0 * (10.0 - t) + log2(p / (1.0 - p));
+
+    return lr - lb_add(0.0, lr);
+}
+
+/******************************************************************************/
+
+/* pi(2^k) - pi(2^(k - 1)), generated using the dlpp2 utility. the ratio
+ * to the DLP.4.proposition.2 bound is ~(1.0001 .. 1.052) for k in [8, 40]
+ * (1.0001 at k = 8, 1.052 at k = 9, 1.015 at k = 40), and tends to:
+ * 1 / (2 * 0.71867 * ln(2)) ~ (1.0037). the bound fails for k in {4, 6, 7}
+ * (ratio < 1), which is why dlp_ld is only used for (k >= 8) : */
+
+#define DLP_PI_K (40)
+
+static const double dlp_pi_lut[DLP_PI_K + 1] =
+{
+    0, 0, 2, 2,
+    2, 5, 7, 13,
+    23, 43, 75, 137,
+    255, 464, 872, 1612,
+    3030, 5709, 10749, 20390,
+    38635, 73586, 140336, 268216,
+    513708, 985818, 1894120, 3645744,
+    7027290, 13561907, 26207278, 50697537,
+    98182656, 190335585, 369323305, 717267168,
+    1394192236, 2712103833, 5279763824, 10285641778,
+    20051180846
+};
+
+/* lb(2^k / (pi(2^k) - pi(2^(k - 1)))), for k >= 8 : */
+
+static double dlp_ld (unsigned int k)
+{
+    if (k <= DLP_PI_K) /* exact: */
+        return k - log2(dlp_pi_lut[k]);
+
+    return log2(k / 0.71867);
+}
+
 /******************************************************************************/
 
-#if (0) /* RBJ.3,4 estimate: */
+/* RBJ.3,4 estimate: */
 
 static const double rbj_lut[31] = /* RBJ.2.L2 : c(s) sequence: */
 {
@@ -176,17 +510,35 @@ static const double rbj_lut[31] = /* RBJ.2.L2 : c(s) sequence: */
 };
 
 
+/* c(s), from the table for (s <= 30), or the upper bound from the
+ * trigamma series for larger (s), rounded up (see: rbjcs.c) : */
+
+static double rbj_cs (double rs)
+{
+    double x, x2, p;
+
+    if (rs < 31.0)
+        return rbj_lut[(unsigned int) rs];
+
+    x = 1.0 / floor(rs), x2 = x * x;
+    p = 1.0 - x * 0.5 + x2 * (1.0 / 6.0 - x2 * (1.0 / 30.0 - x2 / 42.0));
+
+    return (p + x * p) + 4.0 * DBL_EPSILON; /* (1 + x) * r(s) / x */
+}
+
+
 /* the inner-most summation of 'N1' : note that c(s) evaluation has been
  * moved inside the summation over (m). this requires very little extra
- * effort relative to the exp2 function overhead, as (s) is clamped, and
- * the c(s) values have been precomputed. */
+ * effort relative to the exp2 function overhead. (s) is the largest
+ * value permitted by RBJ.3, rather than clamped to the default (30), as
+ * c(s) is decreasing. */
 
 static double rbj_ktm (double rk, double rt, double rm)
 {
     double rj, rs, r0 = 0.0;
     unsigned int jh, ji;
 
-    rs = 30.0; /* RBJ.3 default. */
+    rs = HUGE_VAL; /* (jh >= 3) */
 
     jh = (unsigned int) ceil(rm);
     for (rj = 2.0, ji = 2; ji <= jh; rj += 1.0, ji++)
@@ -205,28 +557,78 @@ static double rbj_ktm (double rk, double rt, double rm)
 
     r0 *= exp2(- rm * rt);
 
-    return (r0 * rbj_lut[(unsigned int) rs]); /* c(s) */
+    return (r0 * rbj_cs(rs)); /* c(s) */
 }
 
 
-/* rbj_kt: this is an implementation of the estimate in RBJ.3, using the
- * default value for (q). the results match those in RBJ.table.4 - except
- * for where the combined (italicized) values have been used. */
+/* the values: rbj_ktm(k, t, qi / q), coincide across (q), wherever
+ * g = gcd(qi, q) > 1, with those for: (qi / g) / (q / g). each value is
+ * evaluated once, for the reduced fraction, by rbj_mv_init(k, t), and
+ * stored in: rbj_mv[(q - 1) * RBJ_MS + qi]. the (q) rows are distributed
+ * over the threads if built with OpenMP support. */
+
+#ifndef RBJ_QMAX
+#define RBJ_QMAX (8)
+#endif
+
+#define RBJ_MH (512) /* (mh < 2 * sqrt(k)), for (k <= 2^16). */
+#define RBJ_MS (RBJ_QMAX * RBJ_MH + 1) /* (row stride) */
+
+static double rbj_mv[RBJ_QMAX * RBJ_MS];
 
-static double rbj_kt (unsigned int k, unsigned int t)
+static unsigned int rbj_gcd (unsigned int a, unsigned int b)
 {
-    double rk = k, rt = t, rp, rq;
-    unsigned int q = 4, mh, mi;
+    while (b != 0)
+    {
+        unsigned int r = a % b;
+        a = b, b = r;
+    }
 
-    /* q = q ? q : (4); */ /* RBJ.3 default. */
+    return a;
+}
 
-    /* assert(k > 1 && t >= 1); */
+static void rbj_mv_init (unsigned int k, unsigned int t)
+{
+    double rk = k, rt = t;
+    unsigned int mh;
+    int q;
+
+    if (k < 10) return; /* no RBJ.3 result. */
+
+    mh = (unsigned int) (2.0 * sqrt(rk - 1.0) - 3.0);
+
+#if defined (_OPENMP)
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (q = 1; q <= RBJ_QMAX; q++)
+    {
+        double rq = 1.0 / q, *mv = rbj_mv + (q - 1) * RBJ_MS;
+        unsigned int uq = (unsigned int) q, qi;
+
+        for (qi = uq * 2 + 1; qi <= uq * mh; qi++)
+            if (rbj_gcd(qi, uq) == 1) /* (integral m, for q = 1, exact) */
+                mv[qi] = rbj_ktm(rk, rt, (uq == 1) ? qi : rq * qi);
+    }
+}
+
+
+/* rbj_ktq: this is an implementation of the estimate in RBJ.3, for a
+ * given (q), with the rbj_ktm() values from rbj_mv_init(k, t). with the
+ * default value: (q = 4), the results match those in RBJ.table.4 - except
+ * for where the combined (italicized) values have been used. */
+
+static double rbj_ktq (unsigned int k, unsigned int t, unsigned int q)
+{
+    double rk = k, rt = t, rp, rq, p1, n0 = 0.0;
+    unsigned int mh, mi, qi;
+
+    /* assert(k > 1 && t >= 1 && q >= 1); */
 
     rp = exp2(- 2.0 * rt); /* (4^-t) [RBJ] */
 
-    if (k < 25) /* Monier-Rabin: */
+    if (k <= RBJ4_K) /* Monier-Rabin: */
     {
-        double p_k1 = p_k1_lut[k];
+        double p_k1 = p_kt_lut[k][0];
 
         if (t > 1)
             rp *= 4.0 * p_k1 / (1.0 - p_k1);
@@ -236,30 +638,26 @@ static double rbj_kt (unsigned int k, unsigned int t)
         if (k < 10) return rp; /* no RBJ.3 result. */
     }
 
-    rq = 1.0 / q; /* (fractional step) */
+    rq = 1.0 / q, p1 = exp2(- dlp_ld(k)); /* (fractional step) */
 
-    /* integral 'M' candidates: */
+    /* integral 'M' candidates. the fractional summation over (m) in:
+     * (2 .. M] is the same for each (M), extended by (q) terms, so it
+     * is accumulated in (n0), rather than repeated for each (M) : */
 
     mh = (unsigned int) (2.0 * sqrt(rk - 1.0) - 3.0);
-    for (mi = 3; mi <= mh; mi++)
+    for (qi = q * 2 + 1, mi = 3; mi <= mh; mi++)
     {
-        /* (q(M - 2)(M + 1)/2) summation terms: */
+        double n1;
 
-        double rm, p1, n1 = 0.0;
-        unsigned int qi;
-
-        /* fractional summation: */
-        for (qi = q * 2 + 1; qi <= q * mi; qi++)
+        for (; qi <= q * mi; qi++) /* (the reduced: qi / q) */
         {
-            /* ensure integral (m) values are exact: */
-            rm = ((qi % q) == 0) ? (qi / q) : (rq * qi);
-            n1 += rbj_ktm(rk, rt, rm);
+            unsigned int g = rbj_gcd(qi, q);
+            n0 += rbj_mv[(q / g - 1) * RBJ_MS + qi / g];
         }
 
-        n1 *= 0.5 * (exp2(rt * rq) - 1.0);
+        n1 = n0 * 0.5 * (exp2(rt * rq) - 1.0);
         n1 += exp2(- (rt * mi + 2.0));
 
-        p1 = 0.71867 / rk;
         if ((n1 /= (n1 + p1)) < rp) /* new 'M' candidate: */
             rp = n1;
     }
@@ -268,73 +666,182 @@ static double rbj_kt (unsigned int k, unsigned int t)
 }
 
 
-/* finding asymptotically optimal values for (q) and (s) is impractical.
- * Burthe suggests the default values as reasonable choices, beyond which
- * the extra effort yields no significant improvement in the estimate. */
-
-#endif /* (RBJ.3,4 estimate) */
+/* Burthe suggests the default (q = 4) as a reasonable choice, beyond
+ * which the extra effort yields no significant improvement; (s) is the
+ * largest permitted value (see: rbj_ktm). the RBJ.3 mode (-r) searches
+ * over (q), for each (k, t) evaluation. */
 
 /******************************************************************************/
 
-/* dlp_kt: this is an implementation of the estimate in DLP.4, with a few
- * simple optimizations. the results match those in DLP.table.1. */
+/* dlp_lkt: this is an implementation of the estimate in DLP.4, with a
+ * few simple optimizations. the results match those in DLP.table.1. */
 
+/* the evaluation is performed in the log domain. for a given (M), the
+ * inner summation over {m .. M} is a geometric series with the ratio:
+ * mt = 2^(1 - t), so the double summation reduces to:
 
-static double dlp_kt (unsigned int k, unsigned int t)
+ * (A(M) - mt^(M + 1) * B(M)) / (1 - mt), for t > 1, or:
+ * (M + 1) * B(M) - C(M), for t = 1,
+
+ * where A, B, C are sums over {2 .. M} of: mt^m(j) * 2^-e(j), 2^-e(j),
+ * and m(j) * 2^-e(j), respectively. these are accumulated as scaled
+ * sums: 2^x * s, extended by one term for each (M) candidate. this is
+ * O(sqrt(k)) rather than O(k) per evaluation, and no intermediate term
+ * is subnormal. for t > 1, A(M) >= 2 * mt^(M + 1) * B(M), so there is
+ * no significant cancellation. */
+
+static double dlp_lkt (unsigned int k, unsigned int t)
 {
-    const double c = (8.0 * (M_PI * M_PI - 6.0) / 3.0);
+    const double lc = log2(8.0 * (M_PI * M_PI - 6.0) / 3.0);
 
-    double rk = k, rt = t, rp, mt;
+    double rk = k, rt = t, lp, lq, l1, xa, sa, xb, sb, sc;
     unsigned int mh, mi;
 
     /* assert(k > 1 && t >= 1); */
 
-    rp = exp2(- 2.0 * rt); /* (4^-t) [RBJ] */
+    lp_kt_evals++, dlp_mopt = 0;
 
-    if (k < 25) /* Monier-Rabin: */
+    lp = - 2.0 * rt; /* lb(4^-t) [RBJ] */
+
+    if (k <= RBJ4_K) /* exact, or Monier-Rabin: */
     {
-        double p_k1 = p_k1_lut[k];
+        double lx = mr_lkt(k, t);
 
-        if (t > 1)
-            rp *= 4.0 * p_k1 / (1.0 - p_k1);
-        else
-            rp = p_k1;
+        if (lx < lp)
+            lp = lx;
 
-        if (k < 8) return rp; /* no DLP.4 result. */
+        if (k < 8) return lp; /* no DLP.4 result. */
     }
 
-    mt = exp2(1.0 - rt);
+    lq = 1.0 - rt; /* lb(mt) */
+    l1 = (t > 1) ? log1p(- exp2(lq)) / M_LN2 : 0.0; /* lb(1 - mt) */
+
+    /* the (j = 2) term, with: m(2) = 3 : */
+
+    xb = - (2.0 + (rk - 1.0) / 2.0), sb = 1.0, sc = 3.0;
+    xa = xb + lq * 3.0, sa = 1.0;
 
     /* integral 'M' candidates: */
 
     mh = (unsigned int) (2.0 * sqrt(rk - 1.0) - 1.0);
     for (mi = 3; mi <= mh; mi++)
     {
-        /* ((M - 2)(M + 1)/2) summation terms: */
+        double ej = mi, xj, r0;
 
-        double r0 = 0.0;
-        unsigned int j;
+        ej += (rk - 1.0) / ej; /* (j = M) term: */
 
-        for (j = 2; j <= mi; j++) /* {j .. M} */
+        if ((xj = lq * mi - ej) > xa)
+            sa = sa * exp2(xa - xj) + 1.0, xa = xj;
+        else
+            sa += exp2(xj - xa);
+
+        if ((xj = - ej) > xb)
+        {
+            double f = exp2(xb - xj);
+            sb = sb * f + 1.0, sc = sc * f + mi, xb = xj;
+        }
+        else
         {
-            unsigned int m = j + (j == 2);
-            double ej = j, mj;
+            double f = exp2(xj - xb);
+            sb += f, sc += mi * f;
+        }
+
+        if (t > 1)
+            r0 = xa - l1 + log2(sa - exp2(lq * (mi + 1) + xb - xa) * sb);
+        else
+            r0 = xb + log2((mi + 1) * sb - sc);
+
+        r0 += lc - 1.0 - lq; /* (c / (2 * mt)) */
+        r0 = lb_add(r0, - (2.0 + rt * mi));
+
+        if ((r0 += dlp_ld(k)) < lp) /* new 'M' candidate: */
+            lp = r0, dlp_mopt = mi;
+    }
+
+    return lp; /* lb(p(k, t)) */
+}
+
 
-            ej += (rk - 1.0) / ej;
-            mj = exp2((1.0 - rt) * m - ej);
+/* dlp_lkt_v: evaluate dlp_lkt for (MRTAB_LANES) values of (k) at once.
+ * the loop over (M) runs to the largest bound in the group, and lanes
+ * with a smaller 'mh' bound are masked. the scaled sums are updated
+ * without branches, so the lane loop is a candidate for vectorization,
+ * e.g., with: -O3 -fopenmp -ffast-math, and a vector exp2 (libmvec). */
 
-            for (r0 += mj; m < mi; m++) /* {m .. M} \ {2} */
-                r0 += (mj *= mt);
+static void dlp_lkt_v (const unsigned int k[], unsigned int t, double lp[])
+{
+    const double lc = log2(8.0 * (M_PI * M_PI - 6.0) / 3.0);
+
+    double rk[MRTAB_LANES], lk[MRTAB_LANES], xa[MRTAB_LANES],
+        sa[MRTAB_LANES], xb[MRTAB_LANES], sb[MRTAB_LANES],
+        sc[MRTAB_LANES], rt = t, lq, l1;
+
+    unsigned int mh[MRTAB_LANES], mmax = 2, mi, l;
+
+    lp_kt_evals += MRTAB_LANES;
+
+    lq = 1.0 - rt; /* lb(mt) */
+    l1 = (t > 1) ? log1p(- exp2(lq)) / M_LN2 : 0.0; /* lb(1 - mt) */
+
+    for (l = 0; l < MRTAB_LANES; l++)
+    {
+        rk[l] = k[l], lp[l] = - 2.0 * rt; /* lb(4^-t) [RBJ] */
+
+        if (k[l] <= RBJ4_K) /* exact, or Monier-Rabin: */
+        {
+            double lx = mr_lkt(k[l], t);
+
+            if (lx < lp[l])
+                lp[l] = lx;
         }
 
-        r0 *= c / (2.0 * mt);
-        r0 += exp2(- (2.0 + rt * mi));
+        mh[l] = (k[l] < 8) ? 2 : /* no DLP.4 result. */
+            (unsigned int) (2.0 * sqrt(rk[l] - 1.0) - 1.0);
 
-        if ((r0 *= rk / 0.71867) < rp) /* new 'M' candidate: */
-            rp = r0;
+        if (mh[l] > mmax)
+            mmax = mh[l];
+
+        lk[l] = (k[l] < 8) ? 0.0 : dlp_ld(k[l]);
+
+        xb[l] = - (2.0 + (rk[l] - 1.0) / 2.0), sb[l] = 1.0, sc[l] = 3.0;
+        xa[l] = xb[l] + lq * 3.0, sa[l] = 1.0;
     }
 
-    return rp; /* p(k, t) */
+    for (mi = 3; mi <= mmax; mi++)
+    {
+        double rm = mi, r2 = - (2.0 + rt * rm);
+
+#if defined (_OPENMP)
+#pragma omp simd
+#endif
+        for (l = 0; l < MRTAB_LANES; l++)
+        {
+            double ej, xj, x, f, g, r0;
+
+            ej = rm + (rk[l] - 1.0) / rm; /* (j = M) term: */
+
+            xj = lq * rm - ej, x = fmax(xa[l], xj);
+            sa[l] = sa[l] * exp2(xa[l] - x) + exp2(xj - x), xa[l] = x;
+
+            xj = - ej, x = fmax(xb[l], xj);
+            f = exp2(xb[l] - x), g = exp2(xj - x), xb[l] = x;
+            sb[l] = sb[l] * f + g, sc[l] = sc[l] * f + rm * g;
+
+            if (t > 1)
+                r0 = xa[l] - l1 + log2(sa[l] -
+                                       exp2(lq * (rm + 1.0) + xb[l] - xa[l]) * sb[l]);
+            else
+                r0 = xb[l] + log2((rm + 1.0) * sb[l] - sc[l]);
+
+            r0 += lc - 1.0 - lq; /* (c / (2 * mt)) */
+
+            x = fmax(r0, r2); /* lb(2^r0 + 2^r2) : */
+            r0 = x + log2(1.0 + exp2(fmin(r0, r2) - x)) + lk[l];
+
+            if (mi <= mh[l] && r0 < lp[l]) /* new 'M' candidate: */
+                lp[l] = r0;
+        }
+    }
 }
 
 
@@ -349,6 +856,185 @@ static double dlp_kt (unsigned int k, unsigned int t)
 
 /******************************************************************************/
 
+/* RBJ.3 mode: the estimate is evaluated for each (q) in {1 .. RBJ_QMAX},
+ * and the least of these and the DLP.4 estimate is taken; both are upper
+ * bounds for p(k, t). the (q) found is only the best on this grid: for
+ * the larger (t), it is (q = RBJ_QMAX), and it moves to the edge of any
+ * larger grid, with a slightly lower estimate. */
+
+/* instrumentation: the (q) that achieved the minimum in the previous
+ * scalar evaluation, or (0) if the DLP.4 estimate was not improved upon: */
+
+static unsigned int rbj_qopt;
+
+
+static double rbj_lkt (unsigned int k, unsigned int t)
+{
+    double lq, lp = dlp_lkt(k, t);
+    unsigned int q;
+
+    rbj_qopt = 0, rbj_mv_init(k, t);
+
+    for (q = 1; q <= RBJ_QMAX; q++)
+        if ((lq = log2(rbj_ktq(k, t, q))) < lp) lp = lq, rbj_qopt = q;
+
+    return lp; /* lb(p(k, t)) */
+}
+
+static void rbj_lkt_v (const unsigned int k[], unsigned int t, double lp[])
+{
+    double lq;
+    unsigned int l, q;
+
+    dlp_lkt_v(k, t, lp);
+
+    for (l = 0; l < MRTAB_LANES; l++)
+    {
+        rbj_mv_init(k[l], t);
+
+        for (q = 1; q <= RBJ_QMAX; q++)
+            if ((lq = log2(rbj_ktq(k[l], t, q))) < lp[l]) lp[l] = lq;
+    }
+}
+
+/******************************************************************************/
+
+/* incremental search: a random odd start (n0), and the candidates: n0,
+ * n0 + 2, .. n0 + 2 * (w - 1), with a window of (w = MRTAB_IWIN * k)
+ * odd values. the first candidate passing (t) M-R iterations is taken;
+ * if there is none, the search restarts. the candidates are no longer
+ * independent, so p(k, t) does not apply directly [7].
+
+ * [7] J. Brandt, I. Damgaard, "On Generation of Probable Primes by
+ * Incremental Search". CRYPTO '92, LNCS 740, 1993, pp. 358-370.
+
+ * each candidate in the window is a uniformly random odd k-bit value,
+ * so by the union bound, the probability of taking a composite is at
+ * most: w * P(composite, passes t) = w * p(k, t) * rho / (1 - p(k, t)),
+ * where (rho) is the probability that a random odd k-bit value is prime.
+ * conditioned on success, i.e., on a window containing at least one
+ * prime - with probability ~ (1 - e^-mu), (mu = w * rho) :
+
+ * q(k, t) <~ p(k, t) / (1 - p(k, t)) * mu / (1 - e^-mu),
+
+ * using: rho = 2 / (k * ln(2)). this is a simpler, and more pessimistic,
+ * estimate than those of [7]. with the default window, (mu ~ 5.77), and
+ * the cost is ~ 2.5 bits of the error bound (2^-s).
+
+ * the union bound is rigorous, but (1 - e^-mu) is a Poisson heuristic
+ * for the prime-in-window probability, not a lower bound - so q(k, t)
+ * is an estimate, and the (-i) table is not a certified bound. */
+
+#ifndef MRTAB_IWIN
+#define MRTAB_IWIN (2)
+#endif
+
+static double mr_rho (unsigned int k) /* random odd k-bit is prime: */
+{
+    if (k <= DLP_PI_K) /* exact: */
+        return dlp_pi_lut[k] / exp2(k - 2.0);
+
+    return 2.0 / (k * M_LN2);
+}
+
+static double inc_lb (unsigned int k, double lp)
+{
+    double rho = mr_rho(k), mu = MRTAB_IWIN * k * rho;
+
+    /* lb(q) = lb(p) - lb(1 - p) + lb(mu / (1 - e^-mu)) : */
+
+    return lp - log1p(- exp2(lp)) / M_LN2 + log2(mu / - expm1(- mu));
+}
+
+static double inc_lkt (unsigned int k, unsigned int t)
+{
+    return inc_lb(k, dlp_lkt(k, t));
+}
+
+static void inc_lkt_v (const unsigned int k[], unsigned int t, double lp[])
+{
+    dlp_lkt_v(k, t, lp);
+
+    for (unsigned int l = 0; l < MRTAB_LANES; l++)
+        lp[l] = inc_lb(k[l], lp[l]);
+}
+
+/******************************************************************************/
+
+/* trial division bound: a random odd k-bit candidate is divided by the
+ * first (n) odd primes, stopping at a factor, and the survivors are
+ * given an M-R test - almost always one exponentiation for a composite.
+ * with the survival fraction: sigma(n) = prod(1 - 1/p), as in sptab,
+ * and (t) iterations for a prime, the expected time per prime found is:
+
+ * E(n) = (1 / rho) * [C_td(n) + sigma(n) * c_exp(k)] + (t - 1) * c_exp(k)
+ * C_td(n) = c_div(k) * (sigma(0) + sigma(1) + .. + sigma(n - 1))
+
+ * the (t) term is independent of (n), so the optimal bound depends only
+ * on (k), and on the measured costs (picoseconds, see: tdbench.c) :
+
+ * c_div(k) = cd * nl, per prime; c_exp(k) = cm(k) * k * nl^2, for (nl)
+ * 64-bit limbs. a prime (p) is worth dividing by if: c_exp / p > c_div;
+ * so the bound grows roughly as (k * nl).
+
+ * the cost per bit and limb^2 is not constant: tdbench measures ~(4x)
+ * between 128 and 512 bits, as the fixed costs of a round are amortized.
+ * so (cm) is given at (128, 256, 512) bits, and cm(k) is interpolated in
+ * lb(k) between these points, and held constant outside them. */
+
+#define MRTAB_TDMAX (6541) /* odd primes < (2^16) */
+
+static unsigned int td_lut[MRTAB_TDMAX];
+
+static void td_init (void)
+{
+    unsigned int n, d, i = 0;
+
+    for (n = 3; i < MRTAB_TDMAX; n += 2)
+    {
+        for (d = 3; d * d <= n && n % d != 0; d += 2);
+        if (d * d > n) td_lut[i++] = n;
+    }
+}
+
+#define MRTAB_TDCM (3) /* cm(k) at: k = 128, 256, 512 */
+
+static double td_cm (unsigned int k, const double *cm)
+{
+    double x = log2((double) k) - 7.0; /* (0 .. MRTAB_TDCM - 1) */
+    unsigned int i;
+
+    if (x <= 0.0)
+        return cm[0];
+
+    if (x >= MRTAB_TDCM - 1)
+        return cm[MRTAB_TDCM - 1];
+
+    i = (unsigned int) x, x -= i;
+
+    return cm[i] + (cm[i + 1] - cm[i]) * x;
+}
+
+static unsigned int td_opt (unsigned int k, double cd, const double *cm)
+{
+    double nl = (double) ((k + 63) / 64), sn = 1.0, ct = 0.0, e, emin, ce;
+    unsigned int n, nopt = 0;
+
+    cd *= nl, ce = td_cm(k, cm) * k * nl * nl; /* c_div(k), c_exp(k) */
+
+    for (emin = ce, n = 0; n < MRTAB_TDMAX; n++)
+    {
+        ct += cd * sn, sn *= 1.0 - 1.0 / td_lut[n];
+
+        if ((e = ct + sn * ce) < emin) /* (1 / rho) * E(n) - (t) term */
+            emin = e, nopt = n + 1;
+    }
+
+    return nopt; /* the number of odd primes. */
+}
+
+/******************************************************************************/
+
 /* how to use the M-R table: the first entry is the maximum (k) value for
  * which (2) iterations of the M-R test are required to guarantee that:
  * p(k, t) <= (2^-s). an entry with a LUT index of (i) is the maximum (k)
@@ -360,25 +1046,167 @@ static double dlp_kt (unsigned int k, unsigned int t)
  * is (tmax = j + 1). usage: "for (t = 1; k <= lut[t - 1]; t++);" */
 
 
+/* --stats : per (t) evaluation counts and processor times for the binary
+ * search and the linear tail phases of the threshold search, written as
+ * a JSON object following the table. */
+
+typedef struct mrtab_stat
+{
+    unsigned long bs_evals, tl_evals; /* (k, t) evaluations. */
+    double bs_time, tl_time; /* processor time (seconds). */
+    unsigned int k, tl_steps, mopt, clamped, pathological;
+}
+mrtab_stat;
+
+
+static void stat_json (FILE *f, unsigned int s, unsigned int tmax,
+                       const mrtab_stat *st, unsigned long kmax_evals,
+                       double kmax_time)
+{
+    unsigned int t;
+
+    fprintf(f, "{\n  \"s\": %u,\n  \"tmax\": %u,\n", s, tmax);
+    fprintf(f, "  \"kmax\": { \"k\": %u, \"evals\": %lu, "
+            "\"time\": %.6f },\n", st[1].k, kmax_evals, kmax_time);
+    fprintf(f, "  \"t\": [");
+
+    for (t = 2; t <= tmax; t++)
+    {
+        const mrtab_stat *sp = st + t;
+
+        fprintf(f, "%s\n    { \"t\": %u, \"k\": %u, \"m\": %u, "
+                "\"clamped\": %u, \"pathological\": %u,\n", (t > 2)
+                ? "," : "", t, sp->k, sp->mopt, sp->clamped,
+                sp->pathological);
+        fprintf(f, "      \"bsearch\": { \"evals\": %lu, "
+                "\"time\": %.6f },\n", sp->bs_evals, sp->bs_time);
+        fprintf(f, "      \"tail\": { \"evals\": %lu, \"steps\": %u, "
+                "\"time\": %.6f } }", sp->tl_evals, sp->tl_steps,
+                sp->tl_time);
+    }
+
+    fprintf(f, "\n  ]\n}\n");
+}
+
+/******************************************************************************/
+
+static void lut_out (const unsigned int *v, unsigned int cnt)
+{
+    unsigned int fw = (cnt != 0 && v[0] > 0xffff) ? (5) : (4), i;
+
+    for (i = 0; i < cnt; i++) /* (8) entries per line: */
+        fprintf(stdout, (i == 0) ? "\n    0x%0*x" : (i % 8) ? ", 0x%0*x" :
+                ",\n    0x%0*x", fw, v[i]);
+
+    fprintf(stdout, "\n\n");
+}
+
+/******************************************************************************/
+
+/* the table is limited to (k <= 2^16). if no threshold value can be
+ * found for (t) within this range, the entry is clamped to (2^16); i.e.,
+ * at least (t) iterations are required for all (k) in the table. */
+
 static const char *usage =
-    "usage: mrtab [s], where: s = 64 .. 256 (default: 128)\n"
-    "M-R test iterations s.t. p(k, t) <= (2^-s), for k > 16.\n";
+    "usage: mrtab [--stats] [-i | -r] [-c cd cm cm cm] [s | -p k], where: "
+    "s = 64 .. 1024 (default: 128),\n"
+    "and the flags may be given in any order, before (s).\n"
+    "M-R test iterations s.t. p(k, t) <= (2^-s), for k > 16.\n"
+    "(-p k) p(k, t) for k = 2 .. 65536, t = 1 .. 16 (see: mcpkt)\n"
+    "(-i) incremental search estimate: q(k, t) <= (2^-s), heuristic\n"
+    "(-r) RBJ.3 estimate, optimized over (q), with the DLP.4 estimate\n"
+    "(-c cd cm cm cm) trial division bound for each entry, with costs "
+    "(ps, see: tdbench):\n"
+    "  cd : division, per limb and prime; cm : M-R, per bit and limb^2,\n"
+    "  at 128, 256, and 512 bits\n";
 
 int main (int argc, char **argv)
 {
-    p_kt_fn p_kt = dlp_kt; /* default p(k, t) evaluation function. */
+    lp_kt_fn lp_kt = dlp_lkt; /* default p(k, t) evaluation function. */
+    lp_kt_vfn lp_kt_v = dlp_lkt_v;
+
+    unsigned int s = (128), kcap = (65536), kmax, tmax, k, t;
+    unsigned int ttab[(1024) / 2 + 2], ntab[(1024) / 2 + 2];
+    double lpmax;
+
+    static mrtab_stat tstat[(1024) / 2 + 2];
+    unsigned long kmax_evals;
+    double kmax_time;
+    clock_t c0;
 
-    unsigned int s = (128), kmax, tmax, k, t, ttab[256];
-    double pmax;
+    unsigned long cd = 0, cm[MRTAB_TDCM] = {0};
+    double rcm[MRTAB_TDCM];
+    int argi = 1, stats = 0, inc = 0, rbj = 0;
 
-    if (argc > 1) /* exponent option: */
+    for (; argi < argc; argi++) /* flags, in any order: */
+    {
+        if (strcmp(argv[argi], "--stats") == 0)
+            stats = 1;
+
+        else if (strcmp(argv[argi], "-i") == 0 && !rbj)
+        {
+            lp_kt = inc_lkt, lp_kt_v = inc_lkt_v; /* incremental search. */
+            inc = 1;
+        }
+        else if (strcmp(argv[argi], "-r") == 0 && !inc)
+        {
+            lp_kt = rbj_lkt, lp_kt_v = rbj_lkt_v; /* RBJ.3, optimized (q). */
+            rbj = 1;
+        }
+        else if (strcmp(argv[argi], "-c") == 0)
+        {
+            unsigned int i;
+
+            if (argc < argi + 2 + MRTAB_TDCM ||
+                !u32_arg(& cd, argv[argi + 1]) || cd == 0)
+            {
+                fprintf(stderr, "%s", usage);
+                return (1);
+            }
+
+            for (i = 0; i < MRTAB_TDCM; i++)
+            {
+                if (!u32_arg(cm + i, argv[argi + 2 + i]) || cm[i] == 0)
+                {
+                    fprintf(stderr, "%s", usage);
+                    return (1);
+                }
+
+                rcm[i] = (double) cm[i];
+            }
+
+            argi += 1 + MRTAB_TDCM;
+        }
+        else if (strcmp(argv[argi], "-i") == 0 ||
+                 strcmp(argv[argi], "-r") == 0) /* (-i, -r) : */
+        {
+            fprintf(stderr, "%s", usage);
+            return (1);
+        }
+        else
+            break;
+    }
+
+    if (argc > argi) /* exponent option: */
     {
         unsigned long u;
 
-        if (strcmp(argv[1], "-d") == 0)
-            return dlp_tab(p_kt);
+        if (strcmp(argv[argi], "-d") == 0)
+            return dlp_tab(lp_kt_v);
+
+        if (strcmp(argv[argi], "-p") == 0)
+        {
+            if (argc < argi + 2 || !u32_arg(& u, argv[argi + 1]) ||
+                (u < 2) || (u > kcap))
+            {
+                fprintf(stderr, "%s", usage);
+                return (1);
+            }
+
+            return pkt_tab(lp_kt, (unsigned int) u, inc);
+        }
 
-        if (!u32_arg(& u, argv[1]) || (u < 64) || (u > 256))
+        if (!u32_arg(& u, argv[argi]) || (u < 64) || (u > 1024))
         {
             fprintf(stderr, "%s", usage);
             return (1);
@@ -387,15 +1215,31 @@ int main (int argc, char **argv)
         s = (unsigned int) u;
     }
 
-    pmax = exp2(- (double) s);
+    lpmax = - (double) s; /* lb(2^-s) */
     fprintf(stdout, "k from t = 2 (k > 16) s.t. "
-            "p(k, t) <= 2^-%u (%.2e) :\n", s, pmax);
+            "%c(k, t) <= 2^-%u (%.2e) :\n", inc ? 'q' : 'p', s,
+            exp2(lpmax));
+
+    if (inc) /* (window) */
+        fprintf(stdout, "incremental search (estimate), %uk odd "
+                "candidates\n",
+                (unsigned int) (MRTAB_IWIN));
 
 
     /* find kmax s.t. p(kmax, 1) <= (2^-s). kmax must be greater than,
-     * or equal to, the minimum k value s.t. p(k, 1) <= (2^-s) : */
+     * or equal to, the minimum k value s.t. p(k, 1) <= (2^-s), or is
+     * clamped to the table limit: */
+
+    lp_kt_evals = 0, c0 = clock();
+
+    for (kmax = (25); kmax < kcap && (*lp_kt)(kmax, 1) > lpmax; )
+        kmax <<= 1;
 
-    for (kmax = (25); (*p_kt)(kmax, 1) > pmax; kmax <<= 1);
+    if (kmax > kcap)
+        kmax = kcap;
+
+    kmax_evals = lp_kt_evals, tstat[1].k = kmax;
+    kmax_time = (double) (clock() - c0) / CLOCKS_PER_SEC;
 
     /* find tmax s.t. p(k, t) <= (2^-s), for k > 16. the result from
      * [RBJ] yields: tmax = ceil(s/2), for k >= 2. (s) is an integral
@@ -413,6 +1257,19 @@ int main (int argc, char **argv)
         unsigned int k0 = (16) + 1, k1 = kmax;
         int found = 0;
 
+        mrtab_stat *st = tstat + t;
+        lp_kt_evals = 0, c0 = clock();
+
+        if (kmax == kcap && (*lp_kt)(kmax, t - 1) > lpmax)
+        {
+            ttab[t] = st->k = kmax; /* clamped entry. */
+            st->bs_evals = lp_kt_evals, st->clamped = 1;
+            st->bs_time = (double) (clock() - c0) / CLOCKS_PER_SEC;
+
+            if (stats) (*lp_kt)(kmax, t), st->mopt = dlp_mopt;
+            continue;
+        }
+
         /* if: p(k + 1, t - 1) <= pmax < p(k, t - 1), assert that:
          * p(k, t) < p(k, t - 1). it does not follow, although it is
          * almost certainly the case, that: p(k, t) <= pmax. */
@@ -421,20 +1278,45 @@ int main (int argc, char **argv)
         {
             k = k0 + (k1 - k0) / 2;
 
-            if ((*p_kt)(k + 1, t - 1) > pmax) /* (k > k0) */
+            if ((*lp_kt)(k + 1, t - 1) > lpmax) /* (k > k0) */
                 k0 = k + 1;
 
-            else if ((*p_kt)(k, t - 1) <= pmax) /* (k < k1) */
+            else if ((*lp_kt)(k, t - 1) <= lpmax) /* (k < k1) */
                 k1 = k - 1;
 
             else /* sweet spot: */
             {
-                while ((*p_kt)(k, t) > pmax) k++;
+                unsigned int ks = k;
+
+                st->bs_evals = lp_kt_evals, lp_kt_evals = 0;
+                st->bs_time = (double) (clock() - c0) / CLOCKS_PER_SEC;
+                c0 = clock();
+
+                /* scan (k) in steps of (MRTAB_LANES) : */
+
+                for (;;)
+                {
+                    unsigned int kv[MRTAB_LANES], l;
+                    double lv[MRTAB_LANES];
+
+                    for (l = 0; l < MRTAB_LANES; l++)
+                        kv[l] = k + l;
+
+                    (*lp_kt_v)(kv, t, lv);
+
+                    for (l = 0; l < MRTAB_LANES && lv[l] > lpmax; l++);
+                    if (k += l, l < MRTAB_LANES) break;
+                }
+
+                st->tl_evals = lp_kt_evals, st->tl_steps = k - ks;
+                st->tl_time = (double) (clock() - c0) / CLOCKS_PER_SEC;
 
                 if (k > kmax) /* pathological case (?) */
                 {
                     unsigned int ti;
 
+                    st->pathological = 1;
+
                     /* warning: found a local maxima in p(k, t).
                      * ensure that the table contains a sequence of
                      * non-increasing (k) values: */
@@ -444,7 +1326,8 @@ int main (int argc, char **argv)
                         ttab[ti] = k;
                 }
 
-                ttab[t] = kmax = k, found = 1;
+                ttab[t] = st->k = kmax = k, found = 1;
+                if (stats) (*lp_kt)(k, t), st->mopt = dlp_mopt;
             }
         }
 
@@ -455,25 +1338,45 @@ int main (int argc, char **argv)
         if (!found) tmax = t - 1;
     }
 
-#if (1)
-#define MRTAB_FMT "0x%04x" /* threshold value LUT: */
-#else
-#define MRTAB_FMT "%6u"
-#endif
+    ttab[++tmax] = 0; /* EOT entry. */
+    lut_out(ttab + 2, tmax - 1); /* threshold value LUT: */
 
-    fprintf(stdout, "\n    "MRTAB_FMT, ttab[2]);
+    if (rbj) /* best (q) on the grid, at each threshold (k) value: */
+    {
+        /* the entry (k) for (t) is placed by: p(k + 1, t - 1) <= 2^-s,
+         * so (q) and lb(p) are given for that evaluation: */
 
-    ttab[++tmax] = 0; /* EOT entry. */
+        fprintf(stdout, "best (q) in {1 .. %u} for RBJ.3 at each threshold "
+                "(k), (0 : DLP.4), (* : q = %u, the grid edge) :\n\n"
+                "  t :     k :   q : lb(p(k + 1, t - 1)) :  DLP.4\n",
+                RBJ_QMAX, RBJ_QMAX);
+
+        for (t = 2; t < tmax; t++)
+        {
+            double lp = rbj_lkt(ttab[t] + 1, t - 1);
 
-    for (t = 3; t <= tmax; t++)
+            fprintf(stdout, "%3u : %5u : %2u%c : %19.4f : %9.4f\n", t,
+                    ttab[t], rbj_qopt, (rbj_qopt == RBJ_QMAX) ? '*' : ' ',
+                    lp, dlp_lkt(ttab[t] + 1, t - 1));
+        }
+
+        fprintf(stdout, "\n");
+    }
+
+    if (cd != 0) /* trial division LUT, at each threshold (k) value: */
     {
-        if ((t - 2) % 8 != 0)
-            fprintf(stdout, ", "MRTAB_FMT, ttab[t]);
-        else
-            fprintf(stdout, ",\n    "MRTAB_FMT, ttab[t]);
+        td_init();
+
+        for (t = 2; t < tmax; t++)
+            ntab[t] = td_opt(ttab[t], (double) cd, rcm);
+
+        fprintf(stdout, "odd primes for trial division (cd = %lu ps, "
+                "cm = %lu, %lu, %lu ps) :\n", cd, cm[0], cm[1], cm[2]);
+        lut_out(ntab + 2, tmax - 2);
     }
 
-    fprintf(stdout, "\n\n");
+    if (stats) /* (tmax) excludes the EOT entry: */
+        stat_json(stdout, s, tmax - 1, tstat, kmax_evals, kmax_time);
 
     /* the M-R implementation must handle candidates with (16) or fewer
      * significant bits explicitly, requiring up to (54) trial divisions;
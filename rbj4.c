@@ -2,6 +2,11 @@
 
 /* RBJ.4 : exact p(k, 1) values for 2 <= k <= 24 (Monier's result) : */
 
+/* the same census pass also yields exact p(k, t) values, for t > 1 :
+ * p(k, t) = sum{(S(n) / (n - 1))^t} / (sum{(S(n) / (n - 1))^t} + P),
+ * where the sum is over the k-bit odd composites, and (P) is the number
+ * of k-bit primes. */
+
 /* Copyright (c) 2020 Brett Hale.
  * distributed under BSD-2-Clause license terms. see: mrtab.c */
 
@@ -14,6 +19,7 @@
 #include <math.h>
 
 #include "spk12.h" /* small prime factorization. */
+#include "ddreal.h" /* double-double arithmetic. */
 
 #if defined (QUADMATH)
 #pragma GCC diagnostic ignored "-Wpedantic" /* (Q-suffix) */
@@ -84,6 +90,18 @@ int main (void)
     unsigned int kmax = (24), k; /* {0 .. kmax} table: */
     double pk[(24) + 1];
 
+    unsigned int tmax = (10), ti; /* p(k, t), t = {1 .. tmax} table: */
+    double pkt[(24) + 1][(10) + 1];
+
+    /* double-double (and optional long double) evaluation of p(k, 1),
+     * accumulated in the same pass: */
+
+    ddreal pkd[(24) + 1];
+
+#if defined (LDMATH)
+    long double pkl[(24) + 1];
+#endif
+
     /* bias summation terms such that: fp{p(k, 1)} >= p(k, 1) */
 
     /* Burthe [2] mentions 'several hours' on a SPARC I. at this time,
@@ -92,12 +110,26 @@ int main (void)
     pk[0] = 1.0, pk[1] = 1.0; /* all fail. */
     pk[2] = 0.0, pk[3] = 0.0; /* all pass. */
 
+    for (k = 0; k < 4; k++)
+        for (ti = 1; ti <= tmax; ti++) pkt[k][ti] = pk[k];
+
     for (k = 4; k <= kmax; k++)
     {
-        uint32_t nmax = (UINT32_C(1) << k), n, sn;
-        double num, den, en, ed, an, x, t;
+        uint32_t nmax = (UINT32_C(1) << k), n, sn, np = 0;
+        double num, den, en, ed, an, at, x, t;
+        ddreal dnum, dden, dn;
+
+        /* 2Sum series for: sum{(S(n) / (n - 1))^t}, t > 1 : */
+
+        double numt[(10) + 1] = {0.0}, ent[(10) + 1] = {0.0};
+
+#if defined (LDMATH)
+        long double lnum, lden, lan, lx, lt, eln, eld;
+        lnum = lden = 0.0L, eln = eld = 0.0L; /* 2Sum series: */
+#endif
 
         num = den = 0.0, en = ed = 0.0; /* 2Sum series: */
+        dnum = dden = dd_from(0.0);
 
         for (n = (nmax >> 1) + 1; n < nmax; n += 2)
         {
@@ -108,18 +140,91 @@ int main (void)
 
                 x = num + an; t = x - num;
                 en += num - (x - t) + (an - t); num = x;
+
+                dn = dd_div_d((double) sn, (double) (n - 1));
+                dnum = dd_add(dnum, dn), dden = dd_add(dden, dn);
+
+                for (at = an, ti = 2; ti <= tmax; ti++)
+                {
+                    double ax = (at = nextafter(at * an, DBL_MAX));
+
+                    double xt = numt[ti] + ax, tt = xt - numt[ti];
+                    ent[ti] += numt[ti] - (xt - tt) + (ax - tt);
+                    numt[ti] = xt;
+                }
+
+#if defined (LDMATH)
+                lan = (long double) sn / (long double) (n - 1);
+
+                lx = lnum + lan; lt = lx - lnum;
+                eln += lnum - (lx - lt) + (lan - lt); lnum = lx;
+#endif
             }
             else
-                an = 1.0;
+            {
+                an = 1.0, np++;
+                dden = dd_add_d(dden, 1.0);
+
+#if defined (LDMATH)
+                lan = 1.0L;
+#endif
+            }
 
             x = den + an; t = x - den;
             ed += den - (x - t) + (an - t); den = x;
+
+#if defined (LDMATH)
+            lx = lden + lan; lt = lx - lden;
+            eld += lden - (lx - lt) + (lan - lt); lden = lx;
+#endif
         }
 
         pk[k] = nextafter((num + en) / (den + ed), DBL_MAX);
         fprintf(stdout, "%2u : %.16e\n", k, pk[k]);
+
+        for (pkt[k][1] = pk[k], ti = 2; ti <= tmax; ti++)
+        {
+            x = numt[ti] + ent[ti]; /* (P) is exact: */
+            pkt[k][ti] = nextafter(x / (x + (double) np), DBL_MAX);
+        }
+
+        pkd[k] = dd_div(dnum, dden);
+
+#if defined (LDMATH)
+        pkl[k] = (lnum + eln) / (lden + eld);
+#endif
+    }
+
+    /* evaluate with double-double precision to show that:
+     * 0 <= (fp{p(k, 1)} - p(k, 1)) / p(k, 1) < (2.0) * (EPS) */
+
+    for (k = 4; k <= kmax; k++)
+    {
+        const char *const fmt = "k = %2u : rel = %.16e, "
+            "rel / DBL_EPS = %2.2f (dd)\n";
+
+        ddreal rerr = dd_sub(dd_from(pk[k]), pkd[k]);
+        double rel = dd_to(dd_div(rerr, pkd[k]));
+
+        fprintf(stdout, fmt, k, rel, rel / DBL_EPSILON);
     }
 
+#if defined (LDMATH)
+
+    /* long double (with 2Sum series) : this is less precise than the
+     * double-double result, but usually sufficient for the same bound. */
+
+    for (k = 4; k <= kmax; k++)
+    {
+        const char *const fmt = "k = %2u : rel = %.16Le, "
+            "rel / DBL_EPS = %2.2Lf (ld)\n";
+
+        long double rerr = (pk[k] - pkl[k]) / pkl[k];
+        fprintf(stdout, fmt, k, rerr, rerr / DBL_EPSILON);
+    }
+
+#endif
+
 #if defined (QUADMATH)
 
     /* evaluate with quad precision to show that:
@@ -188,6 +293,21 @@ int main (void)
     /* since p(k, 1) < 1/5 for 2 <= k <= 24, the Monier-Rabin theorem
      * yields: p(k, t) <= 4^(1-t) * p(k, 1) / (1 - p(k, 1)) < (4^-t). */
 
+    /* exact p(k, t) values, {t = 1 .. tmax}, for each (k) : */
+
+    fprintf(stdout, "    {");
+
+    for (k = 0; k <= kmax; k++)
+    {
+        fprintf(stdout, " /* k = %u : */\n        %.16e", k, pkt[k][1]);
+
+        for (ti = 2; ti <= tmax; ti++)
+            fprintf(stdout, (ti % 3 != 1) ? ", %.16e" : ",\n        %.16e",
+                    pkt[k][ti]);
+
+        fprintf(stdout, (k < kmax) ? "\n    },\n    {" : "\n    }\n\n");
+    }
+
     return (0);
 }
 
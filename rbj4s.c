@@ -0,0 +1,338 @@
+/******************************************************************************/
+
+/* RBJ.4 : exact p(k, t) values for 1 <= t <= 10, extending the rbj4
+ * census (k <= 24) with a segmented factorization sieve. the values in
+ * mrtab's p_kt_lut are from (k = 25 .. 34), i.e., (k <= RBJ4_K); (k = 20
+ * .. 24) were run as a check against rbj4. (k = 35 .. 40) are accepted,
+ * but have not been run: the time is ~(2^(k - 34)) times that of k = 34. */
+
+/* the sieve is multi-threaded if built with OpenMP support, e.g.,
+ * 'cc -O2 -fopenmp'. each k-bit range is ~(2^(k - 2)) odd values, so
+ * the time doubles with each (k) : (k = 25 .. 32) takes ~(12) minutes,
+ * and (k = 33, 34) ~(40) minutes, on a single core. */
+
+/* Copyright (c) 2020 Brett Hale.
+ * distributed under BSD-2-Clause license terms. see: mrtab.c */
+
+/******************************************************************************/
+
+/* rbj4 factors each (n) with sp_factor(), which is limited to (n < 2^24).
+ * here, the odd values of a segment are factored together: each prime
+ * (p <= sqrt(n)) is stepped through the segment, as in dlpp2.c, and the
+ * terms of Monier's formula for S(n) are accumulated for each value:
+
+ * S(n) = (1 + (2^(w * v) - 1) / (2^w - 1)) * prod{gcd(u(n), p - 1)},
+
+ * over the (w) distinct prime factors (p) of (n), with: v = min{v2(p - 1)},
+ * and u(n) the largest odd factor of (n - 1). the cofactor that remains
+ * after sieving is (1) or a prime. the summation is the same as rbj4's,
+ * with each term biased s.t. fp{p(k, t)} >= p(k, t). */
+
+/* the census yields values only for the (k) it visits. a rigorous p(k, 1)
+ * bound up to (k = 64) would need the composites with a large S(n) /
+ * (n - 1) to be enumerated by their structure, and the remainder bounded
+ * analytically; that is not implemented. the exact values are used as
+ * far as the census has been run; beyond that, the DLP.4 estimate
+ * applies. */
+
+/******************************************************************************/
+
+#include <inttypes.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+#include <float.h>
+#include <math.h>
+
+#include "ddreal.h" /* double-double arithmetic. */
+
+#if defined (_OPENMP)
+#include <omp.h>
+#endif
+
+
+/* return (1) if the nul-terminated C string forms a valid
+ * 32-bit unsigned integer value in C locale decimal format,
+ * and store the value in (u); return (0) otherwise: */
+
+static int u32_arg (unsigned long *u, const char *s)
+{
+    int ret;
+
+    if ((ret = *s) != 0)
+    {
+        unsigned long x = 0, d;
+
+        if (ret == '0') /* "0" or not a decimal format: */
+            return (s[1] ? (0) : (*u = x) == 0);
+
+        for (; (d = (unsigned long) (*s++)) != 0; x += d)
+        {
+            if ((d -= ('0')) > (9) ||
+                (x > (0xffffffffUL / (10)))) return (0);
+            if ((x *= (10)) > (0xffffffffUL - d))
+                return (0);
+        }
+
+        *u = x; /* a valid 32-bit unsigned integer value. */
+    }
+
+    return ret;
+}
+
+/* return gcd(u, v), where: (0 <= u, v < 2^64) : */
+
+static uint64_t ugcd (uint64_t u, uint64_t v)
+{
+    /* additional iteration if (u < v) : */
+    for (uint64_t t = 0; (t = v) != 0; u = t)
+        v = u % v;
+
+    return u;
+}
+
+/******************************************************************************/
+
+#define SEG_ODDS (UINT32_C(1) << 15) /* odd values per segment. */
+#define TMAX (10)
+
+/* the census of a k-bit range: sum{(S(n) / (n - 1))^t} over the odd
+ * composites, as 2Sum series (num, en), and the number of primes: */
+
+typedef struct rbj_sum
+{
+    double num[TMAX + 1], en[TMAX + 1];
+    uint64_t np;
+}
+rbj_sum;
+
+
+/* the Monier state for each odd value in a segment: the unfactored part,
+ * the product of: gcd(u(n), p - 1), the number of distinct prime factors,
+ * and the minimum v2(p - 1) : */
+
+typedef struct rbj_seg
+{
+    uint64_t rem[SEG_ODDS], gp[SEG_ODDS];
+    uint8_t wn[SEG_ODDS], vn[SEG_ODDS];
+}
+rbj_seg;
+
+
+static unsigned int v2 (uint64_t x) /* (x > 0) */
+{
+    unsigned int v = 0;
+
+    for (; (x & 0x1) == 0; x >>= 1) v++;
+    return v;
+}
+
+static void rbj_add (rbj_seg *sg, uint32_t i, uint64_t n, uint64_t p)
+{
+    uint64_t u = (n - 1) >> v2(n - 1);
+    unsigned int vp = v2(p - 1);
+
+    sg->gp[i] *= ugcd(u % (p - 1), p - 1);
+    sg->wn[i] += 1;
+
+    if (vp < sg->vn[i])
+        sg->vn[i] = (uint8_t) vp;
+}
+
+/* sieve the segments {b0 .. b1 - 1} of odd values, where the segment (b)
+ * is: [2 * b * SEG_ODDS + 1, 2 * (b + 1) * SEG_ODDS + 1) : */
+
+static void rbj_range (rbj_sum *rs, uint64_t b0, uint64_t b1,
+                       const uint32_t *sp, uint32_t np)
+{
+    rbj_seg *sg = malloc(sizeof(rbj_seg));
+
+    if (sg == NULL)
+        abort();
+
+    for (uint64_t b = b0; b < b1; b++)
+    {
+        uint64_t lo = b * SEG_ODDS * 2 + 1, hi = lo + SEG_ODDS * 2;
+        uint32_t i, j;
+
+        for (i = 0; i < SEG_ODDS; i++)
+            sg->rem[i] = lo + 2 * i, sg->gp[i] = 1, sg->wn[i] = 0,
+                sg->vn[i] = 64;
+
+        for (j = 0; j < np && (uint64_t) sp[j] * sp[j] < hi; j++)
+        {
+            uint64_t p = sp[j], x = (lo + p - 1) / p * p;
+
+            for (x = (x & 0x1) ? x : x + p; x < hi; x += 2 * p)
+            {
+                uint64_t q = sg->rem[i = (uint32_t) ((x - lo) >> 1)] / p;
+
+                while (q % p == 0)
+                    q /= p;
+
+                sg->rem[i] = q;
+                rbj_add(sg, i, x, p);
+            }
+        }
+
+        for (i = 0; i < SEG_ODDS; i++)
+        {
+            uint64_t n = lo + 2 * i, sn = 1;
+            double an, at;
+            unsigned int t;
+
+            if (sg->rem[i] == n) /* prime: */
+            {
+                rs->np++;
+                continue;
+            }
+
+            if (sg->rem[i] != 1) /* (prime cofactor) */
+                rbj_add(sg, i, n, sg->rem[i]);
+
+            /* Monier's formula for S(n) : (w * v < 64) */
+
+            sn = 1 + ((sn << (sg->wn[i] * sg->vn[i])) - 1) /
+                ((sn << sg->wn[i]) - 1);
+            sn *= sg->gp[i];
+
+            an = (double) sn / (double) (n - 1);
+            an = nextafter(an, DBL_MAX);
+
+            for (at = an, t = 1; t <= TMAX; t++)
+            {
+                double x = rs->num[t] + at, d = x - rs->num[t];
+
+                rs->en[t] += rs->num[t] - (x - d) + (at - d);
+                rs->num[t] = x;
+
+                at = nextafter(at * an, DBL_MAX);
+            }
+        }
+    }
+
+    free(sg);
+}
+
+/******************************************************************************/
+
+int main (int argc, char **argv)
+{
+    uint32_t k0 = (25), k1 = (32), pmax, np, i, *sp;
+    double pkt[(40) + 1][TMAX + 1];
+    uint8_t *c;
+
+    for (i = 1; i < (uint32_t) argc && i < 3; i++) /* [k0 [k1]] : */
+    {
+        unsigned long u;
+
+        if (!u32_arg(& u, argv[i]) || (u < 20) || (u > 40) ||
+            (i == 2 && u < k0))
+        {
+            fprintf(stderr, "usage: rbj4s [k0 [k1]], where: "
+                    "20 <= k0 <= k1 <= 40 (default: 25 32)\n");
+            return (1);
+        }
+
+        if (i == 1)
+            k0 = k1 = (uint32_t) u;
+        else
+            k1 = (uint32_t) u;
+    }
+
+    pmax = (UINT32_C(1) << ((k1 + 1) / 2)); /* p < sqrt(2^k1) */
+
+    /* odd primes < pmax (sieve of Eratosthenes) : */
+
+    c = calloc(pmax, 1), sp = malloc(pmax / 2 * sizeof(uint32_t));
+
+    if (c == NULL || sp == NULL)
+        return (1);
+
+    for (np = 0, i = 3; i < pmax; i += 2)
+    {
+        if (c[i] != 0) /* composite: */
+            continue;
+
+        for (uint64_t j = (uint64_t) i * i; j < pmax; j += 2 * i)
+            c[j] = 1;
+
+        sp[np++] = i;
+    }
+
+    free(c);
+
+    for (uint32_t k = k0; k <= k1; k++)
+    {
+        /* the k-bit odd values: [2^(k - 1) + 1, 2^k), with (k >= 20)
+         * a whole number of segments: */
+
+        uint64_t bk = (UINT64_C(1) << (k - 2)) / SEG_ODDS;
+        ddreal dnum[TMAX + 1];
+        uint64_t pk = 0;
+        unsigned int t;
+
+        for (t = 1; t <= TMAX; t++)
+            dnum[t] = dd_from(0.0);
+
+#if defined (_OPENMP)
+#pragma omp parallel
+#endif
+        {
+            rbj_sum rs = {{0.0}, {0.0}, 0};
+            unsigned int tid = 0, nth = 1, j;
+
+#if defined (_OPENMP)
+            tid = (unsigned int) omp_get_thread_num();
+            nth = (unsigned int) omp_get_num_threads();
+#endif
+
+            rbj_range(& rs, bk + bk * tid / nth, bk + bk * (tid + 1) / nth,
+                      sp, np);
+
+#if defined (_OPENMP)
+#pragma omp critical
+#endif
+            {
+                for (j = 1; j <= TMAX; j++)
+                    dnum[j] = dd_add_d(dd_add_d(dnum[j], rs.num[j]),
+                                       rs.en[j]);
+                pk += rs.np;
+            }
+        }
+
+        for (t = 1; t <= TMAX; t++) /* (P) is exact: */
+        {
+            double x = nextafter(dd_to(dnum[t]), DBL_MAX);
+            pkt[k][t] = nextafter(x / (x + (double) pk), DBL_MAX);
+        }
+
+        fprintf(stdout, "%2"PRIu32" : %.16e : %12"PRIu64" primes\n",
+                k, pkt[k][1], pk);
+        fflush(stdout);
+    }
+
+    free(sp);
+
+    /* exact p(k, t) values, {t = 1 .. TMAX}, in the format of rbj4 : */
+
+    fprintf(stdout, "\n    {");
+
+    for (uint32_t k = k0; k <= k1; k++)
+    {
+        unsigned int t;
+
+        fprintf(stdout, " /* k = %"PRIu32" : */\n        %.16e", k,
+                pkt[k][1]);
+
+        for (t = 2; t <= TMAX; t++)
+            fprintf(stdout, (t % 3 != 1) ? ", %.16e" : ",\n        %.16e",
+                    pkt[k][t]);
+
+        fprintf(stdout, (k < k1) ? "\n    },\n    {" : "\n    }\n\n");
+    }
+
+    return (0);
+}
+
+/******************************************************************************/
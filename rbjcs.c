@@ -1,6 +1,19 @@
 /******************************************************************************/
 
-/* RBJ.2.L2 : c(s) sequence: */
+/* RBJ.2.L2 : c(s) sequence: c(s) = (s + 1) * r(s), where (r(s)) is the
+ * tail of the series for zeta(2) : sum{1 / j^2, j > s} */
+
+/* the table is generated by direct summation for s <= smax (default: 30).
+ * for larger (s), mrtab evaluates an upper bound from the asymptotic series
+ * for the trigamma function, with r(s) = psi'(s + 1). the bounds alternate
+ * with each truncated (Bernoulli) term, for all (s > 0) :
+
+ * r(s) < 1/s - 1/(2s^2) + 1/(6s^3) - 1/(30s^5) + 1/(42s^7),
+
+ * and the next term: -1/(30s^9), yields a lower bound. so the relative
+ * error of the upper bound is < 1/(30s^8) : ~(4e-14) at (s = 31), and
+ * less than the error of the direct summation for (s > 40). this is
+ * checked against the double-double summation. */
 
 /* Copyright (c) 2020 Brett Hale.
  * distributed under BSD-2-Clause license terms. see: mrtab.c */
@@ -8,6 +21,7 @@
 /******************************************************************************/
 
 #include <inttypes.h>
+#include <stdlib.h>
 #include <stdio.h>
 
 #include <float.h>
@@ -17,16 +31,79 @@
 #define M_PI (3.14159265358979323846264338327950288)
 #endif
 
+#include "ddreal.h" /* double-double arithmetic. */
+
 #if defined (QUADMATH)
 #pragma GCC diagnostic ignored "-Wpedantic" /* (Q-suffix) */
 #include <quadmath.h>
 #endif
 
+#define RBJ_SMAX (4096)
 
-int main (void)
+
+/* return (1) if the nul-terminated C string forms a valid
+ * 32-bit unsigned integer value in C locale decimal format,
+ * and store the value in (u); return (0) otherwise: */
+
+static int u32_arg (unsigned long *u, const char *s)
+{
+    int ret;
+
+    if ((ret = *s) != 0)
+    {
+        unsigned long x = 0, d;
+
+        if (ret == '0') /* "0" or not a decimal format: */
+            return (s[1] ? (0) : (*u = x) == 0);
+
+        for (; (d = (unsigned long) (*s++)) != 0; x += d)
+        {
+            if ((d -= ('0')) > (9) ||
+                (x > (0xffffffffUL / (10)))) return (0);
+            if ((x *= (10)) > (0xffffffffUL - d))
+                return (0);
+        }
+
+        *u = x; /* a valid 32-bit unsigned integer value. */
+    }
+
+    return ret;
+}
+
+/* the upper bound for c(s), (s > 0), as evaluated by mrtab : with x = 1/s,
+ * c(s) = (1 + x) * r(s) / x, and (c(s) < 1.65). the (EPS) terms bound the
+ * rounding error of the evaluation: */
+
+static double rbj_cs_tail (double s)
+{
+    double x = 1.0 / s, x2 = x * x, p;
+
+    p = 1.0 - x * 0.5 + x2 * (1.0 / 6.0 - x2 * (1.0 / 30.0 - x2 / 42.0));
+
+    return (p + x * p) + 4.0 * DBL_EPSILON;
+}
+
+/******************************************************************************/
+
+int main (int argc, char **argv)
 {
     unsigned int smax = (30), s; /* {0 .. smax} table: */
-    double c[(30) + 1], r;
+    static double c[RBJ_SMAX + 1];
+    double r;
+
+    if (argc > 1) /* (smax) option: */
+    {
+        unsigned long u;
+
+        if (!u32_arg(& u, argv[1]) || (u < 1) || (u > RBJ_SMAX))
+        {
+            fprintf(stderr, "usage: rbjcs [smax], where: "
+                    "smax = 1 .. %u (default: 30)\n", RBJ_SMAX);
+            return (1);
+        }
+
+        smax = (unsigned int) u;
+    }
 
     /* bias summation terms such that: fp{c(s)} >= c(s) */
 
@@ -35,18 +112,96 @@ int main (void)
 
     for (s = 1; s <= smax; s++)
     {
-        double x = - 1.0 / (double) (s * s);
+        double x = - 1.0 / ((double) s * s);
         r += nextafter(x, DBL_MAX);
 
         c[s] = (s + 1) * r; /* fp{r(s)} > r(s) */
     }
 
+    /* evaluate with double-double precision to show that:
+     * 0 <= (fp{c(s)} - c(s)) / c(s) < (s + 1) * (EPS) */
+
+    {
+        /* zeta(2) = pi^2 / 6 = (hi + lo) : */
+
+        ddreal rd = {1.6449340668482264e+00, 3.0406723503984763e-17};
+        double tmin = HUGE_VAL, tmax = - HUGE_VAL;
+
+        for (s = 0; s <= smax; s++)
+        {
+            const char *const fmt = "s = %2u : rel = %.16e, "
+                "rel / DBL_EPS = %2.2f (dd)\n";
+
+            ddreal cd, rerr;
+            double rel;
+
+            if (s != 0) /* (exact) 1 / s^2 : */
+                rd = dd_sub(rd, dd_div_d(1.0, (double) s * s));
+
+            cd = dd_mul_d(rd, (double) (s + 1));
+            rerr = dd_sub(dd_from(c[s]), cd);
+            rel = dd_to(dd_div(rerr, cd));
+
+            if (s <= 30 || (s & (s - 1)) == 0 || s == smax)
+                fprintf(stdout, fmt, s, rel, rel / DBL_EPSILON);
+
+            if (s > 30) /* upper bound for: (s > 30) */
+            {
+                rerr = dd_sub(dd_from(rbj_cs_tail(s)), cd);
+                rel = dd_to(dd_div(rerr, cd));
+
+                if (rel < tmin) tmin = rel;
+                if (rel > tmax) tmax = rel;
+            }
+        }
+
+        /* 0 <= (fp{tail(s)} - c(s)) / c(s), for: 30 < s <= smax */
+
+        if (smax > 30)
+            fprintf(stdout, "tail : s = 31 .. %u : rel / DBL_EPS = "
+                    "%.2f .. %.2f (dd)\n", smax, tmin / DBL_EPSILON,
+                    tmax / DBL_EPSILON);
+    }
+
+#if defined (LDMATH)
+
+    /* long double (Kahan summation) : less precise than double-double,
+     * but sufficient to show the same bound. */
+
+    {
+        long double rl = 1.644934066848226436472415166646025189L, el = 0.0L;
+
+        for (s = 0; s <= smax; s++)
+        {
+            const char *const fmt = "s = %2u : rel = %.16Le, "
+                "rel / DBL_EPS = %2.2Lf (ld)\n";
+
+            long double cl, rerr;
+
+            if (s != 0)
+            {
+                long double y, t; /* Kahan summation: */
+
+                y = - 1.0L / ((long double) s * s) - el;
+                t = rl + y; el = (t - rl) - y; rl = t;
+            }
+
+            cl = (s + 1) * rl;
+            rerr = (c[s] - cl) / cl;
+
+            fprintf(stdout, fmt, s, rerr, rerr / DBL_EPSILON);
+        }
+    }
+
+#endif
+
 #if defined (QUADMATH)
 
     /* evaluate with quad precision to show that:
      * 0 <= (fp{c(s)} - c(s)) / c(s) < (s + 1) * (EPS) */
 
-    __float128 cq[(30) + 1], rq, eq;
+    static __float128 cq[RBJ_SMAX + 1];
+    __float128 rq, eq;
 
     rq = M_PIq * M_PIq / 6.0, eq = 0.0;
     cq[0] = rq;
@@ -55,7 +210,7 @@ int main (void)
     {
         __float128 y, t; /* Kahan summation: */
 
-        y = - 1.0 / (__float128) (s * s) - eq;
+        y = - 1.0 / ((__float128) s * s) - eq;
         t = rq + y; eq = (t - rq) - y; rq = t;
 
         cq[s] = (s + 1) * rq;
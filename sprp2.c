@@ -11,6 +11,7 @@
 #include <stdio.h>
 
 #include "spk12.h" /* small prime factorization. */
+#include "sprpstat.h" /* (-DSPRP_STATS) instrumentation. */
 
 
 static int is_prime (uint32_t n)
@@ -44,31 +45,40 @@ static int sprp (uint32_t n, uint32_t a)
     while ((m & (UINT32_C(1) << s)) == 0) s++;
     r = m >> s; /* r, s s.t. 2^s * r = n - 1, r in odd. */
 
+    SPRP_STAT_ENTER(s);
+
     {
         uint64_t u = 1, w = a;
 
         while (r != 0)
         {
             if ((r & 0x1) != 0)
-                u = (u * w) % n; /* (mul-rdx) */
+                u = (u * w) % n, SPRP_STAT_MUL(); /* (mul-rdx) */
 
             if ((r >>= 1) != 0)
-                w = (w * w) % n; /* (sqr-rdx) */
+                w = (w * w) % n, SPRP_STAT_MUL(); /* (sqr-rdx) */
         }
 
         if ((y = (uint32_t) u) == 1)
+        {
+            SPRP_STAT_LEAVE(0, 0);
             return (1);
+        }
     }
 
     for (j = 1; j < s && y != m; j++)
     {
         uint64_t u = y;
-        u = (u * u) % n; /* (sqr-rdx) */
+        u = (u * u) % n, SPRP_STAT_MUL(); /* (sqr-rdx) */
 
         if ((y = (uint32_t) u) <= 1) /* (n) is composite: */
+        {
+            SPRP_STAT_LEAVE(2, j);
             return (0);
+        }
     }
 
+    SPRP_STAT_LEAVE((y == m) ? 1 : 3, j - 1);
     return (y == m);
 }
 
@@ -80,6 +90,8 @@ int main (void)
      * the overwhelming majority of composite candidates, prior to
      * the independent M-R trials with randomized (a-SPRP) bases. */
 
+    SPRP_STAT_INIT();
+
     fprintf(stdout, "frequency of 2-SPRP strong liars:\n\n");
 
     for (unsigned int k = 4; k <= (24); k++)
@@ -98,6 +110,8 @@ int main (void)
         fprintf(stdout, "%2u : %2"PRIu32" / %7"PRIu32"\n", k, s, c);
     }
 
+    SPRP_STAT_REPORT();
+
     return (0);
 }
 
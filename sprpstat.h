@@ -0,0 +1,290 @@
+/******************************************************************************/
+
+/* optional instrumentation of the sprp() hot path. with '-DSPRP_STATS',
+ * each call records: s = v2(n - 1), the number of modular multiplies,
+ * how it exits, and the number of squarings in the second loop. the
+ * counters are per-thread, and summed by SPRP_STAT_REPORT(). without
+ * '-DSPRP_STATS', every macro expands to nothing. */
+
+/* '-DSPRP_STATS -DSPRP_PERF' also reads the hardware cycle and retired
+ * instruction counts for the process with perf_event_open(2) (Linux).
+ * this requires '-D_GNU_SOURCE' (or '-std=gnu99') for syscall(2). */
+
+/* Copyright (c) 2020 Brett Hale.
+ * distributed under BSD-2-Clause license terms. see: mrtab.c */
+
+/******************************************************************************/
+
+#ifndef SPRP_STAT_H_
+#define SPRP_STAT_H_
+
+#if defined (SPRP_STATS)
+
+#include <inttypes.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+#if defined (_OPENMP)
+#include <omp.h>
+#endif
+
+#if defined (SPRP_PERF)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <string.h>
+#include <unistd.h>
+#endif
+
+
+typedef struct sprp_stat
+{
+    uint64_t calls, mulmods, tsc; /* (tsc) : time-stamp counter cycles. */
+    uint64_t s_hist[65]; /* s = v2(n - 1) */
+    uint64_t exit_one; /* y = 1 after the exponentiation. */
+    uint64_t sq_hist[65]; /* y = (n - 1) after (j) squarings. */
+    uint64_t fail_one, fail_end; /* y = 1, or (j = s - 1) : composite. */
+    uint64_t grp_stop; /* a lane stopped by a witness in its group. */
+    struct sprp_stat *next;
+}
+sprp_stat;
+
+/* a program that includes this header through mont64.h may not report
+ * the counts, e.g., a benchmark; the helpers are then unused: */
+
+#if defined (__GNUC__)
+#define SPRP_STAT_UNUSED __attribute__((unused))
+#else
+#define SPRP_STAT_UNUSED
+#endif
+
+static sprp_stat *sprp_st_head, *sprp_st; /* (all threads), (this thread) */
+
+#if defined (_OPENMP)
+#pragma omp threadprivate(sprp_st)
+#endif
+
+/******************************************************************************/
+
+static inline uint64_t sprp_tsc (void)
+{
+#if defined (__x86_64__) || defined (__i386__)
+    return __builtin_ia32_rdtsc();
+#else
+    return (0); /* (no cycle counts) */
+#endif
+}
+
+SPRP_STAT_UNUSED static sprp_stat *sprp_stat_new (void)
+{
+    sprp_stat *st = calloc(1, sizeof(sprp_stat));
+
+    if (st == NULL)
+        abort();
+
+#if defined (_OPENMP)
+#pragma omp critical (sprp_stat)
+#endif
+    st->next = sprp_st_head, sprp_st_head = st;
+
+    return st;
+}
+
+
+/* per-call state is local to sprp(), so a counter is only written once
+ * per call, by the calling thread: */
+
+#define SPRP_STAT_ENTER(s) \
+    uint64_t sprp_nm_ = 0, sprp_t0_ = sprp_tsc(); \
+    unsigned int sprp_s_ = (s)
+
+#define SPRP_STAT_MUL() (sprp_nm_++)
+
+
+/* exit (x) : 0 = y = 1 after the exponentiation, 1 = y = (n - 1) after
+ * (j) squarings, 2 = y = 1 after (j) squarings, 3 = no (n - 1) : */
+
+#define SPRP_STAT_LEAVE(x, j) do { \
+    sprp_stat *st_ = sprp_st; \
+    if (st_ == NULL) st_ = sprp_st = sprp_stat_new(); \
+    st_->calls++, st_->mulmods += sprp_nm_; \
+    st_->tsc += sprp_tsc() - sprp_t0_, st_->s_hist[sprp_s_]++; \
+    switch (x) { \
+    case 0: st_->exit_one++; break; \
+    case 1: st_->sq_hist[(j)]++; break; \
+    case 2: st_->fail_one++; break; \
+    default: st_->fail_end++; break; } \
+    } while (0)
+
+
+/* a kernel that tests (cnt <= SPRP_STAT_LANES) bases of the same (n) in
+ * lock-step: each base is a call, with its own multiplies and exit, for
+ * lane (l). exit (4) : the lane was stopped by a witness in another lane.
+ * the kernel's cycles are added once, by SPRP_STAT_DONE_N() : */
+
+#define SPRP_STAT_LANES (16)
+
+#define SPRP_STAT_ENTER_N(s) \
+    uint64_t sprp_nm_[SPRP_STAT_LANES] = {0}, sprp_t0_ = sprp_tsc(); \
+    unsigned int sprp_s_ = (s)
+
+#define SPRP_STAT_MUL_N(l) (sprp_nm_[(l)]++)
+
+#define SPRP_STAT_LEAVE_N(l, x, j) do { \
+    sprp_stat *st_ = sprp_st; \
+    if (st_ == NULL) st_ = sprp_st = sprp_stat_new(); \
+    st_->calls++, st_->mulmods += sprp_nm_[(l)], st_->s_hist[sprp_s_]++; \
+    switch (x) { \
+    case 0: st_->exit_one++; break; \
+    case 1: st_->sq_hist[(j)]++; break; \
+    case 2: st_->fail_one++; break; \
+    case 3: st_->fail_end++; break; \
+    default: st_->grp_stop++; break; } \
+    } while (0)
+
+#define SPRP_STAT_DONE_N() do { \
+    sprp_stat *st_ = sprp_st; \
+    if (st_ == NULL) st_ = sprp_st = sprp_stat_new(); \
+    st_->tsc += sprp_tsc() - sprp_t0_; \
+    } while (0)
+
+/******************************************************************************/
+
+#if defined (SPRP_PERF)
+
+static int sprp_perf_fd[2] = {-1, -1}; /* cycles, instructions */
+
+SPRP_STAT_UNUSED static void sprp_perf_open (void)
+{
+    const uint64_t cfg[2] = {
+        PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS};
+
+    for (unsigned int i = 0; i < 2; i++)
+    {
+        struct perf_event_attr pe;
+        int fd;
+
+        memset(& pe, 0, sizeof(pe));
+        pe.type = PERF_TYPE_HARDWARE, pe.size = sizeof(pe);
+        pe.config = cfg[i], pe.disabled = 1, pe.inherit = 1;
+        pe.exclude_kernel = 1, pe.exclude_hv = 1;
+
+        /* this process, and the threads it creates, on any cpu: */
+
+        fd = (int) syscall(SYS_perf_event_open, & pe, 0, -1, -1, 0);
+
+        if ((sprp_perf_fd[i] = fd) < 0)
+        {
+            fprintf(stderr, "sprp_stat: perf_event_open unavailable\n");
+            return;
+        }
+
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+}
+
+SPRP_STAT_UNUSED static uint64_t sprp_perf_read (unsigned int i)
+{
+    uint64_t x = 0;
+
+    if (sprp_perf_fd[i] < 0 || read(sprp_perf_fd[i], & x, sizeof(x))
+        != (ssize_t) sizeof(x)) return (0);
+
+    return x;
+}
+
+#define SPRP_STAT_INIT() sprp_perf_open()
+
+#else
+
+#define SPRP_STAT_INIT() ((void) 0)
+
+#endif /* (SPRP_PERF) */
+
+/******************************************************************************/
+
+#define SPRP_STAT_REPORT() sprp_stat_report(stderr)
+
+SPRP_STAT_UNUSED static void sprp_stat_report (FILE *f)
+{
+    sprp_stat t = {0};
+    unsigned int i;
+
+    for (sprp_stat *st = sprp_st_head; st != NULL; st = st->next)
+    {
+        t.calls += st->calls, t.mulmods += st->mulmods, t.tsc += st->tsc;
+        t.exit_one += st->exit_one;
+        t.fail_one += st->fail_one, t.fail_end += st->fail_end;
+        t.grp_stop += st->grp_stop;
+
+        for (i = 0; i < 65; i++)
+            t.s_hist[i] += st->s_hist[i], t.sq_hist[i] += st->sq_hist[i];
+    }
+
+    if (t.calls == 0)
+        return;
+
+    fprintf(f, "sprp: %"PRIu64" calls, %"PRIu64" mulmods "
+            "(%.2f per call)\n", t.calls, t.mulmods,
+            (double) t.mulmods / (double) t.calls);
+
+    if (t.tsc != 0)
+        fprintf(f, "sprp: %.1f tsc cycles per call, %.2f per mulmod\n",
+                (double) t.tsc / (double) t.calls,
+                (double) t.tsc / (double) t.mulmods);
+
+    fprintf(f, "sprp: exit y = 1 : %"PRIu64", composite: %"PRIu64
+            " (y = 1 : %"PRIu64", no n - 1 : %"PRIu64")\n", t.exit_one,
+            t.fail_one + t.fail_end, t.fail_one, t.fail_end);
+
+    if (t.grp_stop != 0)
+        fprintf(f, "sprp: stopped by a witness in the group : %"PRIu64
+                "\n", t.grp_stop);
+
+    fprintf(f, "sprp: s = v2(n - 1) :\n");
+    for (i = 0; i < 65; i++)
+        if (t.s_hist[i] != 0)
+            fprintf(f, "  s = %2u : %"PRIu64" (%.4f)\n", i, t.s_hist[i],
+                    (double) t.s_hist[i] / (double) t.calls);
+
+    fprintf(f, "sprp: y = n - 1 after j squarings :\n");
+    for (i = 0; i < 65; i++)
+        if (t.sq_hist[i] != 0)
+            fprintf(f, "  j = %2u : %"PRIu64"\n", i, t.sq_hist[i]);
+
+#if defined (SPRP_PERF)
+    {
+        uint64_t cyc = sprp_perf_read(0), ins = sprp_perf_read(1);
+
+        /* process totals; the mulmod figure is an upper bound, as it
+         * includes all work outside of sprp() : */
+
+        if (cyc != 0 && ins != 0)
+            fprintf(f, "perf: %"PRIu64" cycles, %"PRIu64" instructions "
+                    "(IPC = %.2f), <= %.2f cycles per mulmod\n", cyc, ins,
+                    (double) ins / (double) cyc,
+                    (double) cyc / (double) t.mulmods);
+    }
+#endif
+}
+
+/******************************************************************************/
+
+#else /* !(SPRP_STATS) */
+
+#define SPRP_STAT_INIT() ((void) 0)
+#define SPRP_STAT_REPORT() ((void) 0)
+#define SPRP_STAT_ENTER(s) ((void) 0)
+#define SPRP_STAT_MUL() ((void) 0)
+#define SPRP_STAT_LEAVE(x, j) ((void) 0)
+#define SPRP_STAT_ENTER_N(s) ((void) 0)
+#define SPRP_STAT_MUL_N(l) ((void) 0)
+#define SPRP_STAT_LEAVE_N(l, x, j) ((void) 0)
+#define SPRP_STAT_DONE_N() ((void) 0)
+
+#endif /* (SPRP_STATS) */
+
+/******************************************************************************/
+
+#endif /* SPRP_STAT_H_ */
@@ -0,0 +1,602 @@
+/******************************************************************************/
+
+/* bcensus : M-R base census for the deterministic test in prime64.h. for
+ * each bit-length band, the composites that reach the M-R test are
+ * counted by the subset of the bases they survive, and the base ordering
+ * that minimizes the expected number of exponentiations is found. */
+
+/* requires '__int128' extended type. the census is multi-threaded if
+ * built with OpenMP support, e.g., 'cc -O2 -fopenmp'. */
+
+/* Copyright (c) 2020 Brett Hale.
+ * distributed under BSD-2-Clause license terms. see: mrtab.c */
+
+/******************************************************************************/
+
+/* the composites that reach is_prime_u64() in a search are those left by
+ * the trial division, or sieve, of the range operations in prime64.c:
+ * the odd primes < 2^16. every composite (n < 2^32) has such a factor,
+ * so the bands are: [2^(k - 1), 2^k), for k = 36 .. 64.
+
+ * each composite (n) has a 'liar' mask: bit (i) is set if (n) is a strong
+ * pseudoprime to base[i]. for an ordering of the bases, a composite with
+ * mask (x) costs (j + 1) exponentiations, where (j) is the position of
+ * the first base not in (x). the mask histogram determines the expected
+ * cost for every ordering, so each permutation is evaluated exactly.
+
+ * two populations are counted for each band:
+
+ * (1) the candidate stream: the odd values in a random window of (2^w)
+ * odd values, with no factor < 2^16, classified by is_prime_u64(). these
+ * are rejected by base-2 in all but a handful of cases, so the stream
+ * alone cannot rank the later bases.
+
+ * (2) the base-2 strong pseudoprimes (2-SPRP) with no factor < 2^16 -
+ * every composite that reaches the second base with base-2 first. with
+ * -s <spsp2 file>, these are all the 2-SPRPs in the band, for (k) up to
+ * the file's limit, and are weighted by the window's share of the band,
+ * so the stream and the 2-SPRPs form a single expected cost. the liars
+ * of the other bases are only sampled by the window, so base-2 is first
+ * in every ordering that is evaluated. for the other bands, a structured
+ * sample of (BC_NGEN) 2-SPRPs: n = p * q, with q = 1 + c (p - 1), and
+ * c = 2 .. 8, is the only practical source; its cost is per 2-SPRP, and
+ * it is biased toward this form. an order is not given for fewer than
+ * (BC_NMIN) 2-SPRPs. */
+
+/* -h <spsp2 file> : the hashed variant. for (n < 2^k), with the base-2
+ * strong pseudoprimes < (2^k) from the spsp2 utility, a single second
+ * base is selected by a hash of (n) from a table of (BC_HASH) entries.
+ * each entry is the smallest base that is a witness for every 2-SPRP in
+ * its bucket; so a prime costs (2) exponentiations, and a composite is
+ * rejected by base-2, or by the table base. */
+
+/******************************************************************************/
+
+#include <inttypes.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <math.h>
+
+#if defined (_OPENMP)
+#include <omp.h>
+#endif
+
+#include "prime64.h"
+
+#define BC_NB (7) /* the maximum number of bases. */
+#define BC_SEG (UINT32_C(1) << 16) /* odd values per segment. */
+#define BC_HASH (256) /* hashed variant table size. */
+#define BC_NGEN (4096) /* structured 2-SPRP sample, per band. */
+#define BC_NMIN (64) /* the minimum 2-SPRP count for an order. */
+
+
+/* return (1) if the nul-terminated C string forms a valid
+ * 32-bit unsigned integer value in C locale decimal format,
+ * and store the value in (u); return (0) otherwise: */
+
+static int u32_arg (unsigned long *u, const char *s)
+{
+    int ret;
+
+    if ((ret = *s) != 0)
+    {
+        unsigned long x = 0, d;
+
+        if (ret == '0') /* "0" or not a decimal format: */
+            return (s[1] ? (0) : (*u = x) == 0);
+
+        for (; (d = (unsigned long) (*s++)) != 0; x += d)
+        {
+            if ((d -= ('0')) > (9) ||
+                (x > (0xffffffffUL / (10)))) return (0);
+            if ((x *= (10)) > (0xffffffffUL - d))
+                return (0);
+        }
+
+        *u = x; /* a valid 32-bit unsigned integer value. */
+    }
+
+    return ret;
+}
+
+static uint64_t rng_next (uint64_t *x) /* (splitmix64) */
+{
+    uint64_t z = (*x += UINT64_C(0x9e3779b97f4a7c15));
+
+    z = (z ^ (z >> 30)) * UINT64_C(0xbf58476d1ce4e5b9);
+    z = (z ^ (z >> 27)) * UINT64_C(0x94d049bb133111eb);
+
+    return z ^ (z >> 31);
+}
+
+/******************************************************************************/
+
+static uint16_t bp_lut[6542]; /* odd primes < 2^16, EOT entry. */
+
+static void bp_init (void)
+{
+    unsigned int i = 0;
+
+    for (uint32_t n = 3; n < 65536; n += 2)
+        if (p64_sp_test((uint16_t) n)) bp_lut[i++] = (uint16_t) n;
+
+    bp_lut[i] = 0; /* EOT entry (6541 odd primes) */
+}
+
+static int bp_factor (uint64_t n) /* (1) if (n) has a factor in bp_lut */
+{
+    for (const uint16_t *bp = bp_lut; *bp != 0; bp++)
+        if (n % *bp == 0) return (1);
+
+    return (0);
+}
+
+static unsigned int bc_mask (uint64_t n, const uint32_t *base,
+                             unsigned int nb)
+{
+    unsigned int mask = 0, j;
+    mont64 m;
+
+    mont64_init(& m, n);
+
+    for (j = 0; j < nb; j++)
+        mask |= (unsigned int) mont64_sprp(& m, base[j]) << j;
+
+    return mask;
+}
+
+
+/* add the liar masks of the composites with no factor < 2^16 in the odd
+ * values: {lo .. hi}, with at most (BC_SEG) values, to hist[]. if (skip),
+ * the 2-SPRPs are left out - they are counted from the spsp2 file: */
+
+static void bc_segment (uint64_t *hist, uint64_t lo, uint64_t hi,
+                        const uint32_t *base, unsigned int nb, int skip)
+{
+    uint8_t f[BC_SEG];
+    uint64_t nf = (hi - lo) / 2 + 1, i;
+
+    memset(f, 0, nf);
+
+    for (const uint16_t *bp = bp_lut; *bp != 0; bp++)
+    {
+        uint64_t p = *bp, x;
+
+        if ((x = p * p) < lo) /* first odd multiple >= lo : */
+            if (((x = lo + (p - lo % p) % p) & 0x1) == 0) x += p;
+
+        for (i = (x - lo) / 2; i < nf; i += p) f[i] = 1;
+    }
+
+    for (i = 0; i < nf; i++)
+    {
+        uint64_t x = lo + 2 * i;
+        unsigned int mask;
+
+        if (f[i] != 0 || is_prime_u64(x))
+            continue; /* (trial division, or prime) */
+
+        if ((mask = bc_mask(x, base, nb)) & skip & 0x1)
+            continue;
+
+        hist[mask]++;
+    }
+}
+
+/******************************************************************************/
+
+/* add the liar masks of the 2-SPRPs: [2^(k - 1), 2^k), with no factor
+ * < 2^16, from the spsp2 file, to hist[] : */
+
+static uint64_t *spsp_db;
+static size_t spsp_cnt;
+
+static void bc_spsp (uint64_t *hist, unsigned int k,
+                         const uint32_t *base, unsigned int nb)
+{
+    for (size_t i = 0; i < spsp_cnt; i++)
+    {
+        uint64_t n = spsp_db[i];
+
+        if ((n >> (k - 1)) != 1 || bp_factor(n))
+            continue;
+
+        hist[bc_mask(n, base, nb)]++;
+    }
+}
+
+
+/* the structured sample: (BC_NGEN) 2-SPRPs: n = p * q in the band, where
+ * (p, q) are prime, with: q = 1 + c (p - 1). then: ord_p(2) | (n - 1), and
+ * ord_q(2) | (n - 1) for a fraction of (c). the liar masks are added to
+ * hist[], as with bc_spsp() : */
+
+static void bc_gen (uint64_t *hist, unsigned int k,
+                        const uint32_t *base, unsigned int nb,
+                        uint64_t *seed)
+{
+    uint64_t cnt = 0, tries;
+
+    for (tries = 0; cnt < BC_NGEN && tries < (UINT64_C(1) << 32); tries++)
+    {
+        unsigned int c = 2 + (unsigned int) (rng_next(seed) % 7);
+        uint64_t p0 = (uint64_t) sqrt(ldexp(1.0, (int) k - 1) / c);
+        uint64_t p1 = (uint64_t) sqrt(ldexp(1.0, (int) k) / c);
+        uint64_t p = (p0 + rng_next(seed) % (p1 - p0)) | 0x1, q;
+        unsigned int mask;
+        mont_u128 n;
+
+        if (p < 65536 || !is_prime_u64(p))
+            continue;
+
+        q = 1 + c * (p - 1), n = (mont_u128) p * q;
+
+        if ((n >> (k - 1)) != 1 || !is_prime_u64(q))
+            continue;
+
+        if (((mask = bc_mask((uint64_t) n, base, nb)) & 0x1) == 0)
+            continue; /* (not a 2-SPRP) */
+
+        hist[mask]++, cnt++;
+    }
+}
+
+/******************************************************************************/
+
+/* the expected number of exponentiations per composite, for the base
+ * ordering: perm[], given the (weighted) liar mask histogram: */
+
+static double bc_cost (const double *hist, const unsigned int *perm,
+                       unsigned int nb)
+{
+    double tot = 0.0, sum = 0.0;
+
+    for (unsigned int x = 0; x < (1U << nb); x++)
+    {
+        unsigned int j = 0;
+
+        while (j < nb && (x & (1U << perm[j])) != 0) j++;
+
+        /* (j = nb) : a composite that passes every base - impossible
+         * for the deterministic base sets. */
+
+        tot += hist[x], sum += hist[x] * (j + 1);
+    }
+
+    return (tot != 0.0) ? sum / tot : 0.0;
+}
+
+static int next_perm (unsigned int *p, unsigned int n)
+{
+    unsigned int i = n - 1, j = n - 1, t;
+
+    while (i > 0 && p[i - 1] >= p[i]) i--;
+    if (i == 0) return (0);
+
+    while (p[j] <= p[i - 1]) j--;
+    t = p[i - 1], p[i - 1] = p[j], p[j] = t;
+
+    for (j = n - 1; i < j; i++, j--)
+        t = p[i], p[i] = p[j], p[j] = t;
+
+    return (1);
+}
+
+
+/* the least cost over the orderings with the first (nf) bases fixed, and
+ * the cost of the default order in (c0); best[] is the order found: */
+
+static double bc_best (const double *hist, unsigned int *best,
+                       unsigned int nb, unsigned int nf, double *c0)
+{
+    unsigned int perm[BC_NB], i;
+    double cmin;
+
+    for (i = 0; i < nb; i++)
+        perm[i] = best[i] = i;
+
+    *c0 = cmin = bc_cost(hist, perm, nb);
+
+    while (next_perm(perm + nf, nb - nf))
+    {
+        double c = bc_cost(hist, perm, nb);
+
+        if (c < cmin) /* (strict: the default order is kept on a tie) */
+            cmin = c, memcpy(best, perm, sizeof(perm));
+    }
+
+    return cmin;
+}
+
+
+/* (hs) : the stream, (hp) : the 2-SPRPs, with weight (wp) for a file,
+ * or (wp = 0) for the structured sample: */
+
+static void bc_report (unsigned int k, const uint64_t *hs,
+                       const uint64_t *hp, double wp,
+                       const uint32_t *base, unsigned int nb)
+{
+    double hc[1U << BC_NB], p0, p1;
+    unsigned int best[BC_NB], i, mask;
+    uint64_t ns = 0, np = 0;
+
+    for (i = 0; i < (1U << nb); i++)
+        ns += hs[i], np += hp[i], hc[i] = (double) hp[i];
+
+    /* only the base-2 liars are counted over the whole band; the liars
+     * of the other bases are only sampled by the window, so base-2 is
+     * kept first in each ordering: */
+
+    p1 = bc_best(hc, best, nb, 1, & p0); /* (per 2-SPRP) */
+
+    fprintf(stdout, "%4u : %10"PRIu64" : %6"PRIu64" %s : ", k, ns, np,
+            (wp != 0.0) ? "file" : "gen ");
+
+    if (wp != 0.0) /* (per composite, the same ordering) */
+    {
+        unsigned int perm[BC_NB];
+
+        for (i = 0; i < (1U << nb); i++)
+            hc[i] = (double) hs[i] + wp * (double) hp[i];
+
+        for (i = 0; i < nb; i++)
+            perm[i] = i;
+
+        fprintf(stdout, "%.8f %.8f : ", bc_cost(hc, perm, nb),
+                bc_cost(hc, best, nb));
+    }
+    else
+        fprintf(stdout, "%10s %10s : ", "-", "-");
+
+    fprintf(stdout, "%.4f %.4f :", p0, p1);
+
+    if (np < BC_NMIN) /* (too few 2-SPRPs to rank the later bases) */
+    {
+        fprintf(stdout, " -\n");
+        return;
+    }
+
+    for (i = 0; i < nb; i++)
+        fprintf(stdout, " %"PRIu32, base[best[i]]);
+
+    fprintf(stdout, "\n       2-SPRP survivors :");
+
+    for (i = 0, mask = 0; i < nb; i++) /* (the order given) */
+    {
+        uint64_t sv = 0;
+
+        mask |= 1U << best[i];
+
+        for (unsigned int x = 0; x < (1U << nb); x++)
+            sv += ((x & mask) == mask) ? hp[x] : 0;
+
+        fprintf(stdout, " %"PRIu64, sv);
+    }
+
+    fprintf(stdout, "\n");
+}
+
+/******************************************************************************/
+
+static unsigned int spsp_load (const char *path) /* return (k), or (0) */
+{
+    FILE *f = fopen(path, "rb");
+    size_t nc = 0;
+    int c, k;
+
+    if (f == NULL)
+        return (0);
+
+    if ((k = fgetc(f)) < 12 || k > 40) /* (k) byte: */
+        return (fclose(f), 0);
+
+    for (;;) /* 5-byte little-endian records: */
+    {
+        uint64_t x = 0;
+        unsigned int b;
+
+        for (b = 0; b < 5 && (c = fgetc(f)) != EOF; b++)
+            x |= (uint64_t) c << (8 * b);
+
+        if (b != 5)
+            return (fclose(f), (b == 0) ? (unsigned int) k : 0);
+
+        if (spsp_cnt == nc) /* grow the table: */
+        {
+            uint64_t *db;
+
+            nc = (nc != 0) ? (nc * 2) : (1024);
+            if ((db = realloc(spsp_db, nc * sizeof(uint64_t))) == NULL)
+                return (fclose(f), 0);
+
+            spsp_db = db;
+        }
+
+        spsp_db[spsp_cnt++] = x;
+    }
+}
+
+/******************************************************************************/
+
+/* the hashed variant: */
+
+static unsigned int bc_hash (uint64_t n)
+{
+    uint32_t h = (uint32_t) n ^ (uint32_t) (n >> 32);
+
+    return (h * UINT32_C(0x9e3779b1)) >> 24; /* (BC_HASH = 2^8) */
+}
+
+static int bc_hashed (const char *path)
+{
+    static uint32_t tab[BC_HASH];
+    unsigned int k = spsp_load(path), h, maxb = 0;
+
+    if (k == 0)
+        return (1);
+
+#if defined (_OPENMP)
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (h = 0; h < BC_HASH; h++)
+    {
+        uint32_t a = 3;
+        size_t i, j, nm = 0;
+        mont64 *m;
+
+        for (i = 0; i < spsp_cnt; i++) /* (the bucket size) */
+            nm += (bc_hash(spsp_db[i]) == h);
+
+        if ((m = malloc(nm * sizeof(mont64) + sizeof(mont64))) == NULL)
+        {
+            tab[h] = 0;
+            continue;
+        }
+
+        for (i = 0, nm = 0; i < spsp_cnt; i++) /* (the bucket) */
+            if (bc_hash(spsp_db[i]) == h)
+                mont64_init(m + nm++, spsp_db[i]);
+
+        for (j = 0; j < nm; ) /* (restart on a liar) */
+            j = mont64_sprp(m + j, a) ? (a++, 0) : j + 1;
+
+        tab[h] = a, free(m);
+    }
+
+    for (h = 0; h < BC_HASH; h++)
+    {
+        if (tab[h] == 0) /* (allocation failure) */
+            return (1);
+
+        if (tab[h] > maxb) maxb = tab[h];
+    }
+
+    fprintf(stdout, "%zu 2-SPRP composites < 2^%u; hash: (n ^ n >> 32) * "
+            "0x9e3779b1 >> 24; max base: %u\n", spsp_cnt, k, maxb);
+    fprintf(stdout, "\nstatic const uint16_t bc_hash_lut[%u] =\n{",
+            BC_HASH);
+
+    for (h = 0; h < BC_HASH; h++)
+        fprintf(stdout, "%s0x%04"PRIx32, (h == 0) ? "\n    " : (h % 8) ?
+                ", " : ",\n    ", tab[h]);
+
+    fprintf(stdout, "\n};\n");
+
+    return (0);
+}
+
+/******************************************************************************/
+
+static const char *usage =
+    "usage: bcensus [-s <spsp2 file>] [w] | -h <spsp2 file>, where:\n"
+    "w = 16 .. 28 (default: 20)\n"
+    "base census over a window of 2^w odd values per band, and the 2-SPRPs\n"
+    "from the spsp2 file, or a structured sample of 2-SPRPs.\n";
+
+int main (int argc, char **argv)
+{
+    uint64_t seed = 1;
+    unsigned int w = (20), kdb = 0, k;
+    int argi = 1;
+
+    if (argc > 2 && strcmp(argv[1], "-h") == 0)
+    {
+        if (bc_hashed(argv[2]) == 0)
+            return (0);
+
+        fprintf(stderr, "bcensus: invalid spsp2 file: %s\n", argv[2]);
+        return (1);
+    }
+
+    if (argc > 2 && strcmp(argv[1], "-s") == 0)
+    {
+        if ((kdb = spsp_load(argv[2])) == 0)
+        {
+            fprintf(stderr, "bcensus: invalid spsp2 file: %s\n", argv[2]);
+            return (1);
+        }
+
+        argi = 3;
+    }
+
+    if (argc > argi) /* (w) option: */
+    {
+        unsigned long u;
+
+        if (argc > argi + 1 || !u32_arg(& u, argv[argi]) ||
+            (u < 16) || (u > 28))
+        {
+            fprintf(stderr, "%s", usage);
+            return (1);
+        }
+
+        w = (unsigned int) u;
+    }
+
+    bp_init();
+
+    fprintf(stdout, "band :     stream : 2-SPRPs     : per composite"
+            "         : per 2-SPRP    : order\n");
+
+    for (k = 36; k <= 64; k += 4)
+    {
+        static uint64_t hs[1U << BC_NB], hp[1U << BC_NB];
+        const uint32_t *base = p64_sprp64_base;
+        uint64_t lo, nodd, nseg, seg;
+        unsigned int nb, i;
+        int skip = (k <= kdb);
+
+        for (nb = 0; base[nb] != 0; nb++);
+
+        /* a random odd (lo) in: [2^(k - 1), 2^k - 2 nodd], where the
+         * window is clamped to the (2^(k - 2)) odd values of the band: */
+
+        nodd = UINT64_C(1) << ((w < k - 2) ? w : k - 2);
+        lo = (UINT64_C(1) << (k - 1)) + 1 + 2 * (rng_next(& seed) %
+            ((UINT64_C(1) << (k - 2)) - nodd + 1));
+        nseg = nodd / BC_SEG;
+
+        memset(hs, 0, sizeof(hs));
+        memset(hp, 0, sizeof(hp));
+
+#if defined (_OPENMP)
+#pragma omp parallel
+#endif
+        {
+            uint64_t th[1U << BC_NB] = {0};
+
+#if defined (_OPENMP)
+#pragma omp for schedule(dynamic)
+#endif
+            for (seg = 0; seg < nseg; seg++)
+            {
+                uint64_t s0 = lo + seg * BC_SEG * 2;
+                bc_segment(th, s0, s0 + 2 * (BC_SEG - 1), base, nb, skip);
+            }
+
+#if defined (_OPENMP)
+#pragma omp critical
+#endif
+            for (i = 0; i < (1U << nb); i++)
+                hs[i] += th[i];
+        }
+
+        if (skip) /* (the window's share of the band's 2-SPRPs) */
+        {
+            bc_spsp(hp, k, base, nb);
+            bc_report(k, hs, hp, ldexp((double) nodd, 2 - (int) k),
+                      base, nb);
+        }
+        else
+        {
+            bc_gen(hp, k, base, nb, & seed);
+            bc_report(k, hs, hp, 0.0, base, nb);
+        }
+    }
+
+    return (0);
+}
+
+/******************************************************************************/
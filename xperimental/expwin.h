@@ -0,0 +1,97 @@
+/******************************************************************************/
+
+/* left-to-right sliding-window exponentiation: window width selection
+ * and exponent bit extraction, for mp_pow() in mpmont.h.
+ * the exponent is a little-endian array of 64-bit limbs. */
+
+/* [HAC] A.J. Menezes, P.C. van Oorschot, S.A. Vanstone, "Handbook of
+ * Applied Cryptography". CRC Press, 1996. (Algorithm 14.85) */
+
+/* Copyright (c) 2020 Brett Hale.
+ * distributed under BSD-2-Clause license terms. see: mrtab.c */
+
+/******************************************************************************/
+
+/* for a (b)-bit exponent and a (w)-bit window, there are (b - 1) squarings
+ * and ~ b / (w + 1) multiplies, plus (2^(w - 1)) to form the table of odd
+ * powers: {a, a^3, .. a^(2^w - 1)}. the width minimizing the multiplies
+ * is selected; the binary method (w = 1) needs ~ b / 2 multiplies. */
+
+/******************************************************************************/
+
+#ifndef EXP_WIN_H_
+#define EXP_WIN_H_
+
+#include <stdint.h>
+
+#define EW_MAX (6) /* maximum window width. */
+#define EW_TAB (1U << (EW_MAX - 1)) /* odd powers table size. */
+
+
+static inline unsigned int ew_width (unsigned int b)
+{
+    /* w -> (w + 1) where: 2^(w - 1) + b / (w + 1) > 2^w + b / (w + 2) */
+
+    const unsigned int ew_lut[EW_MAX - 1] = {6, 24, 80, 240, 672};
+    unsigned int w = 1;
+
+    while (w < EW_MAX && b > ew_lut[w - 1]) w++;
+
+    return w;
+}
+
+
+/* bit (i) of the exponent: */
+
+static inline unsigned int ew_bit (const uint64_t *e, unsigned int i)
+{
+    return (unsigned int) (e[i / 64] >> (i % 64)) & 0x1;
+}
+
+/* the bit length of an (nl)-limb exponent, (e != 0) : */
+
+static inline unsigned int ew_bits (const uint64_t *e, unsigned int nl)
+{
+    unsigned int b = 64 * nl;
+    uint64_t x;
+
+    while ((x = e[--nl]) == 0) b -= 64;
+    for (b -= 64; x != 0; x >>= 1) b++;
+
+    return b;
+}
+
+
+/* the window with a set high bit (i), of width <= (w), ending in a set
+ * bit (l) >= 0. return the (odd) value of bits: {i .. l}, and store (l) : */
+
+static inline unsigned int ew_window1 (uint64_t e, unsigned int i,
+                                       unsigned int w, unsigned int *l)
+{
+    unsigned int lo = (i + 1 >= w) ? (i + 1 - w) : 0;
+    uint64_t x = (e >> lo) & ((UINT64_C(2) << (i - lo)) - 1);
+
+    for (; (x & 0x1) == 0; lo++) x >>= 1;
+
+    *l = lo;
+    return (unsigned int) x;
+}
+
+static inline unsigned int ew_window (const uint64_t *e, unsigned int i,
+                                      unsigned int w, unsigned int *l)
+{
+    unsigned int q = ((i + 1 >= w) ? (i + 1 - w) : 0) / 64, b = 64 * q, v;
+    uint64_t x = e[q];
+
+    if (i / 64 != q) /* (the window spans two limbs) */
+        x = (x >> 32) | (e[q + 1] << 32), b += 32;
+
+    v = ew_window1(x, i - b, w, l);
+    *l += b;
+
+    return v;
+}
+
+/******************************************************************************/
+
+#endif /* EXP_WIN_H_ */
@@ -0,0 +1,187 @@
+/******************************************************************************/
+
+/* prime factorization for a 64-bit (n > 1), with multiplicity, in the
+ * ascending p[] format of sp_factor(). trial division by the primes in
+ * sp_lut (< 2^12), then a deterministic primality test and Pollard's
+ * rho method (with Brent's cycle detection) for the cofactor. requires
+ * '__int128' extended type. */
+
+/* [7] R.P. Brent, "An Improved Monte Carlo Factorization Algorithm".
+ * BIT Numerical Mathematics, Vol. 20, 1980, pp. 176-184. */
+
+/* Copyright (c) 2020 Brett Hale.
+ * distributed under BSD-2-Clause license terms. see: mrtab.c */
+
+/******************************************************************************/
+
+#ifndef FACTOR64_H_
+#define FACTOR64_H_
+
+#include <stdint.h>
+
+#include "../spk12.h" /* small prime LUT. */
+#include "prime64.h" /* is_prime_u64(), mont64.h */
+
+#define F64_MAX (64) /* the maximum number of prime factors. */
+
+
+static inline uint64_t f64_gcd (uint64_t u, uint64_t v)
+{
+    /* additional iteration if (u < v) : */
+    for (uint64_t t = 0; (t = v) != 0; u = t)
+        v = u % v;
+
+    return u;
+}
+
+/******************************************************************************/
+
+/* a non-trivial factor of an odd composite (n), with the iteration:
+ * x -> x^2 + c (mod n) in the Montgomery domain. the differences are
+ * accumulated in a product, so there is one gcd per (F64_RHO_M) steps;
+ * gcd(x * R, n) = gcd(x, n). if a product collapses to (0), the block
+ * is repeated one step at a time; failing that, (c) is changed. */
+
+#define F64_RHO_M (128)
+
+static inline uint64_t f64_rho (uint64_t n)
+{
+    mont64 m;
+    uint64_t c;
+
+    mont64_init(& m, n);
+
+    for (c = m.r1; ; c = (c + m.r1 >= n) ? c + m.r1 - n : c + m.r1)
+    {
+        uint64_t x = 0, y = m.r1, ys = y, q = m.r1, g = 1, r, k, i;
+
+#define F64_STEP(v) \
+        ((v) = mont64_mul(& m, (v), (v)), \
+         (v) = ((v) >= n - c) ? (v) - (n - c) : (v) + c)
+
+        for (r = 1; g == 1; r *= 2)
+        {
+            for (x = y, i = 0; i < r; i++)
+                F64_STEP(y);
+
+            for (k = 0; k < r && g == 1; k += F64_RHO_M)
+            {
+                ys = y;
+
+                for (i = 0; i < F64_RHO_M && i < r - k; i++)
+                {
+                    F64_STEP(y);
+                    q = mont64_mul(& m, q, (x > y) ? x - y : y - x);
+                }
+
+                g = f64_gcd(n, q);
+            }
+        }
+
+        if (g == n) /* (backtrack) */
+        {
+            do
+            {
+                F64_STEP(ys);
+                g = f64_gcd(n, (x > ys) ? x - ys : ys - x);
+            }
+            while (g == 1);
+        }
+
+#undef F64_STEP
+
+        if (g != n)
+            return g;
+    }
+}
+
+/******************************************************************************/
+
+static inline unsigned int f64_factor (uint64_t p[], uint64_t n)
+{
+    uint64_t sp = sp_lut[0], q, st[F64_MAX];
+    unsigned int np = 0, ns = 0, i, j;
+
+    /* assert(n > 1); */
+
+    for (i = 1; (q = n / sp) >= sp; )
+    {
+        if (q * sp == n)
+            n = q, p[np++] = sp;
+
+        else if ((sp = sp_lut[i++]) == 0) /* EOT entry: */
+            break;
+    }
+
+    /* (n) is a prime unless the LUT is exhausted, where: n > (2^12)^2 */
+
+    if (sp == 0 && !is_prime_u64(n))
+        st[ns++] = n;
+    else
+        p[np++] = n;
+
+    while (ns != 0) /* split the composite cofactors: */
+    {
+        uint64_t c = st[--ns], d = f64_rho(c), e = c / d;
+
+        if (is_prime_u64(d)) p[np++] = d; else st[ns++] = d;
+        if (is_prime_u64(e)) p[np++] = e; else st[ns++] = e;
+    }
+
+    for (i = 1; i < np; i++) /* (ascending order) */
+    {
+        uint64_t x = p[i];
+
+        for (j = i; j > 0 && p[j - 1] > x; j--)
+            p[j] = p[j - 1];
+
+        p[j] = x;
+    }
+
+    return np; /* the number of prime factors (with multiplicity). */
+}
+
+/******************************************************************************/
+
+/* Monier's formula for S(n), the number of bases (a) in [1, n - 1] for
+ * which an odd (n > 1) is an a-SPRP; as in rbj4's sprp_bases(), with
+ * a return value of (0) for a prime: */
+
+static inline uint64_t f64_monier (uint64_t n)
+{
+    uint64_t pbuf[F64_MAX], p, un, sn;
+    unsigned int pn, wn, vn, i;
+
+    if ((pn = f64_factor(pbuf, n)) == 1)
+        return (0);
+
+    /* prime vs. distinct prime factorization: */
+
+    for (wn = 1, p = pbuf[0], i = 1; i < pn; i++)
+    {
+        uint64_t pi = pbuf[i];
+        if (pi != p) pbuf[wn++] = (p = pi);
+    }
+
+    for (vn = (64), i = 0; vn > 1 && i < wn; i++)
+    {
+        uint64_t pi = pbuf[i];
+        unsigned int vi = 0;
+        do pi >>= 1, vi++; while ((pi & 0x1) == 0);
+        if (vi < vn) vn = vi;
+    }
+
+    /* (wn * vn < 64), since: n >= (2^vn + 1)^wn */
+
+    sn = UINT64_C(1);
+    sn = 1 + ((sn << (wn * vn)) - 1) / ((sn << (wn)) - 1);
+
+    for (un = n >> 1; (un & 0x1) == 0; un >>= 1);
+    for (i = 0; i < wn; i++) sn *= f64_gcd(un, pbuf[i] - 1);
+
+    return sn;
+}
+
+/******************************************************************************/
+
+#endif /* FACTOR64_H_ */
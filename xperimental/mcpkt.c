@@ -0,0 +1,234 @@
+/******************************************************************************/
+
+/* mcpkt : Monte Carlo estimate of p(k, t) for single-word (k <= 64). */
+
+/* usage: mrtab [-r] -p k | mcpkt k t [samples] [seed] */
+
+/* requires '__int128' extended type. the sampler is multi-threaded if
+ * built with OpenMP support, e.g., 'cc -O2 -fopenmp'. */
+
+/* Copyright (c) 2020 Brett Hale.
+ * distributed under BSD-2-Clause license terms. see: mrtab.c */
+
+/******************************************************************************/
+
+/* a random, odd k-bit value (n) is subjected to (t) M-R iterations with
+ * random bases in: [1, n - 1], as in the definition of S(n) used for the
+ * exact and estimated p(k, t) values. (an implementation that excludes
+ * the trivial bases: (1, n - 1) can only do better.) if (n) passes (j)
+ * iterations, it is one of the samples for p(k, 1) .. p(k, j), and a
+ * deterministic test decides whether (n) is composite - i.e., a false
+ * acceptance. the estimate is:
+
+ * p(k, j) ~ (false acceptances) / (values passing j iterations),
+
+ * with a Wilson score interval (95%). this is compared to the mrtab value
+ * for the same (k, t), read from the output of: 'mrtab -p k' - the exact
+ * p(k, t) for (k <= 34, t <= 10), or the DLP.4 estimate (or the RBJ.3
+ * estimate, with 'mrtab -r'), and to (4^-t) [RBJ]. an interval whose
+ * lower end exceeds either value is flagged. */
+
+/******************************************************************************/
+
+#include <inttypes.h>
+#include <stdio.h>
+
+#include <math.h>
+
+#if defined (_OPENMP)
+#include <omp.h>
+#endif
+
+#include "prime64.h" /* p64_is_prime_m() */
+
+
+/* return (1) if the nul-terminated C string forms a valid
+ * 64-bit unsigned integer value in C locale decimal format,
+ * and store the value in (u); return (0) otherwise: */
+
+static int u64_arg (uint64_t *u, const char *s)
+{
+    int ret;
+
+    if ((ret = *s) != 0)
+    {
+        uint64_t x = 0, d;
+
+        if (ret == '0') /* "0" or not a decimal format: */
+            return (s[1] ? (0) : (*u = x) == 0);
+
+        for (; (d = (uint64_t) (*s++)) != 0; x += d)
+        {
+            if ((d -= ('0')) > (9) ||
+                (x > (UINT64_MAX / (10)))) return (0);
+            if ((x *= (10)) > (UINT64_MAX - d))
+                return (0);
+        }
+
+        *u = x; /* a valid 64-bit unsigned integer value. */
+    }
+
+    return ret;
+}
+
+/******************************************************************************/
+
+/* xoshiro256** (Blackman, Vigna), seeded with splitmix64 : */
+
+typedef struct rng256
+{
+    uint64_t s[4];
+}
+rng256;
+
+static inline uint64_t rotl64 (uint64_t x, unsigned int r)
+{
+    return (x << r) | (x >> (64 - r));
+}
+
+static void rng_seed (rng256 *g, uint64_t x)
+{
+    for (unsigned int i = 0; i < 4; i++)
+    {
+        uint64_t z = (x += UINT64_C(0x9e3779b97f4a7c15));
+
+        z = (z ^ (z >> 30)) * UINT64_C(0xbf58476d1ce4e5b9);
+        z = (z ^ (z >> 27)) * UINT64_C(0x94d049bb133111eb);
+        g->s[i] = z ^ (z >> 31);
+    }
+}
+
+static inline uint64_t rng_next (rng256 *g)
+{
+    uint64_t *s = g->s, r = rotl64(s[1] * 5, 7) * 9, t = s[1] << 17;
+
+    s[2] ^= s[0], s[3] ^= s[1], s[1] ^= s[2], s[0] ^= s[3];
+    s[2] ^= t, s[3] = rotl64(s[3], 45);
+
+    return r;
+}
+
+/******************************************************************************/
+
+#define TMAX (16)
+
+
+/* read the p(k, t) values for t = 1 .. TMAX from the output of:
+ * 'mrtab -p k', into lut[1 .. TMAX]. return (0) on error, or if the
+ * table is not for (k) : */
+
+static int pkt_read (FILE *f, uint64_t k, double *lut)
+{
+    unsigned int kf, t, j;
+
+    if (fscanf(f, "p(k, t) for k = %u :", & kf) != 1 || kf != k)
+        return (0);
+
+    for (j = 1; j <= TMAX; j++)
+        if (fscanf(f, " t = %u : %le (2^%*f)", & t, lut + j) != 2 ||
+            t != j) return (0);
+
+    return (1);
+}
+
+int main (int argc, char **argv)
+{
+    uint64_t k = 0, t = 0, ns = UINT64_C(1) << 24, seed = 1;
+    uint64_t pass[TMAX + 1] = {0}, fail[TMAX + 1] = {0};
+    double lut[TMAX + 1];
+
+    if (argc < 3 || !u64_arg(& k, argv[1]) || (k < 4) || (k > 64) ||
+        !u64_arg(& t, argv[2]) || (t < 1) || (t > TMAX) ||
+        (argc > 3 && (!u64_arg(& ns, argv[3]) || ns == 0)) ||
+        (argc > 4 && !u64_arg(& seed, argv[4])) ||
+        !pkt_read(stdin, k, lut))
+    {
+        fprintf(stderr, "usage: mrtab [-r] -p k | mcpkt < k = 4 .. 64 > "
+                "< t = 1 .. %u > [samples (default: 2^24)] [seed]\n",
+                TMAX);
+        return (1);
+    }
+
+    SPRP_STAT_INIT();
+
+#if defined (_OPENMP)
+#pragma omp parallel
+#endif
+    {
+        uint64_t tp[TMAX + 1] = {0}, tf[TMAX + 1] = {0}, i, i0, i1;
+        unsigned int tid = 0, nth = 1, j;
+        rng256 g;
+
+#if defined (_OPENMP)
+        tid = (unsigned int) omp_get_thread_num();
+        nth = (unsigned int) omp_get_num_threads();
+#endif
+
+        rng_seed(& g, seed * UINT64_C(0x100000001b3) + tid);
+        i0 = ns * tid / nth, i1 = ns * (tid + 1) / nth;
+
+        for (i = i0; i < i1; i++)
+        {
+            uint64_t n = rng_next(& g) >> (64 - k);
+            mont64 m;
+
+            n |= (UINT64_C(1) << (k - 1)) | 0x1; /* odd, k-bit: */
+            mont64_init(& m, n);
+
+            for (j = 0; j < t; j++) /* random base in: [1, n - 1] */
+                if (!mont64_sprp(& m, 1 + rng_next(& g) % (n - 1))) break;
+
+            if (j == 0)
+                continue;
+
+            /* (n) passed (j) iterations: */
+
+            if (p64_is_prime_m(& m))
+                while (j != 0) tp[j--]++;
+            else
+                while (j != 0) tp[j]++, tf[j--]++;
+        }
+
+#if defined (_OPENMP)
+#pragma omp critical
+#endif
+        for (j = 1; j <= t; j++)
+            pass[j] += tp[j], fail[j] += tf[j];
+    }
+
+    fprintf(stdout, "p(k, t) for k = %"PRIu64", from %"PRIu64" samples "
+            "(95%% Wilson interval) :\n\n", k, ns);
+
+    for (unsigned int j = 1; j <= t; j++)
+    {
+        const double z = 1.959963984540054; /* (97.5%) */
+        double n = (double) pass[j], p, c, h, lo, hi, rb, mp = lut[j];
+
+        if (pass[j] == 0)
+        {
+            fprintf(stdout, "t = %2u : no values passed\n", j);
+            continue;
+        }
+
+        p = (double) fail[j] / n;
+
+        c = (p + z * z / (2.0 * n)) / (1.0 + z * z / n);
+        h = z * sqrt(p * (1.0 - p) / n + z * z / (4.0 * n * n))
+            / (1.0 + z * z / n);
+
+        lo = (c - h > 0.0) ? (c - h) : 0.0, hi = c + h;
+        rb = exp2(- 2.0 * j); /* (4^-t) [RBJ] */
+
+        fprintf(stdout, "t = %2u : %"PRIu64" / %"PRIu64" = %.4e "
+                "[%.4e, %.4e], mrtab = %.4e, 4^-t = %.4e%s\n", j,
+                fail[j], pass[j], p, lo, hi, mp, rb,
+                (lo > rb) ? " (exceeds 4^-t)" :
+                (lo > mp) ? " (exceeds mrtab)" : "");
+    }
+
+    SPRP_STAT_REPORT();
+
+    return (0);
+}
+
+/******************************************************************************/
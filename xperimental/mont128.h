@@ -0,0 +1,176 @@
+/******************************************************************************/
+
+/* Montgomery arithmetic for an odd, 128-bit modulus (n), with (R = 2^128),
+ * as two 64-bit limbs. requires '__int128' extended type. */
+
+/* Copyright (c) 2020 Brett Hale.
+ * distributed under BSD-2-Clause license terms. see: mrtab.c */
+
+/******************************************************************************/
+
+/* values are held as 'mont_u128', but the compiler's 128 x 128-bit
+ * multiply only yields the low half, so the product is formed by a CIOS
+ * multiply, unrolled for two limbs, as in mpmont.h. the (s + 2) word
+ * accumulator: (t0, t1, t2, t3) is sufficient for any odd (n < 2^128). */
+
+/******************************************************************************/
+
+#ifndef MONT128_H_
+#define MONT128_H_
+
+#include <stdint.h>
+
+#include "mont64.h" /* mont_u128 */
+
+
+typedef struct mont128
+{
+    mont_u128 n, r1, r2; /* n, R (mod n), R^2 (mod n) */
+    uint64_t ni; /* -n^-1 (mod 2^64) */
+}
+mont128;
+
+/******************************************************************************/
+
+/* a + b (mod n), a - b (mod n), and a / 2 (mod n), where: (a, b < n) : */
+
+static inline mont_u128 mont128_add (const mont128 *m, mont_u128 a,
+                                     mont_u128 b)
+{
+    mont_u128 x = a + b;
+    return (x < a || x >= m->n) ? (x - m->n) : x;
+}
+
+static inline mont_u128 mont128_sub (const mont128 *m, mont_u128 a,
+                                     mont_u128 b)
+{
+    return (a < b) ? (a - b + m->n) : (a - b);
+}
+
+static inline mont_u128 mont128_half (const mont128 *m, mont_u128 a)
+{
+    /* (a + n) / 2, without overflow, for odd (a) : */
+    return ((a & 0x1) == 0) ? (a >> 1) : (a >> 1) + (m->n >> 1) + 1;
+}
+
+
+/* REDC(a * b), where: (a, b < n) : */
+
+static inline mont_u128 mont128_mul (const mont128 *m, mont_u128 a,
+                                     mont_u128 b)
+{
+    uint64_t a0 = (uint64_t) a, a1 = (uint64_t) (a >> 64);
+    uint64_t b0 = (uint64_t) b, b1 = (uint64_t) (b >> 64);
+    uint64_t n0 = (uint64_t) m->n, n1 = (uint64_t) (m->n >> 64);
+    uint64_t t0, t1, t2, t3, q;
+    mont_u128 x, t;
+
+    /* limb (b0) : t = (a * b0 + q * n) / 2^64 */
+
+    x = (mont_u128) a0 * b0, t0 = (uint64_t) x;
+    x = (mont_u128) a1 * b0 + (x >> 64);
+    t1 = (uint64_t) x, t2 = (uint64_t) (x >> 64);
+
+    q = t0 * m->ni;
+    x = (mont_u128) q * n0 + t0;
+    x = (mont_u128) q * n1 + t1 + (x >> 64);
+    t0 = (uint64_t) x, x = (mont_u128) t2 + (x >> 64);
+    t1 = (uint64_t) x, t2 = (uint64_t) (x >> 64);
+
+    /* limb (b1) : t = (t + a * b1 + q * n) / 2^64 */
+
+    x = (mont_u128) a0 * b1 + t0, t0 = (uint64_t) x;
+    x = (mont_u128) a1 * b1 + t1 + (x >> 64), t1 = (uint64_t) x;
+    x = (mont_u128) t2 + (x >> 64);
+    t2 = (uint64_t) x, t3 = (uint64_t) (x >> 64);
+
+    q = t0 * m->ni;
+    x = (mont_u128) q * n0 + t0;
+    x = (mont_u128) q * n1 + t1 + (x >> 64);
+    t0 = (uint64_t) x, x = (mont_u128) t2 + (x >> 64);
+    t1 = (uint64_t) x, t2 = t3 + (uint64_t) (x >> 64);
+
+    t = ((mont_u128) t1 << 64) | t0; /* (t < 2n) */
+
+    return (t2 != 0 || t >= m->n) ? (t - m->n) : t;
+}
+
+
+static inline void mont128_init (mont128 *m, mont_u128 n)
+{
+    uint64_t n0 = (uint64_t) n, ni = n0;
+    mont_u128 r2;
+    unsigned int i;
+
+    /* assert(n > 1 && (n & 0x1) != 0); */
+
+    for (i = 0; i < 5; i++)
+        ni *= 2 - n0 * ni; /* Newton: 2^6, 2^12, .. 2^96 */
+
+    m->n = n, m->ni = - ni;
+    m->r1 = (- n) % n; /* (2^128 - n) mod n */
+
+    /* REDC((2R)^2) = 4R, .. : seven squarings of (2R) yield R * 2^128,
+     * rather than (128) modular doublings of (R) : */
+
+    for (r2 = mont128_add(m, m->r1, m->r1), i = 0; i < 7; i++)
+        r2 = mont128_mul(m, r2, r2);
+
+    m->r2 = r2;
+}
+
+
+static inline mont_u128 mont128_to (const mont128 *m, mont_u128 a)
+{
+    return mont128_mul(m, a % m->n, m->r2); /* a * R (mod n) */
+}
+
+static inline mont_u128 mont128_from (const mont128 *m, mont_u128 a)
+{
+    return mont128_mul(m, a, 1); /* a * R^-1 (mod n) */
+}
+
+/******************************************************************************/
+
+/* a-SPRP test for an odd (n > 2), in the Montgomery domain. a return
+ * value of (1) if (a = 0 mod n), as with mont64_sprp(). */
+
+static inline int mont128_sprp (const mont128 *m, mont_u128 a)
+{
+    mont_u128 n = m->n, r = n - 1, one = m->r1, neg = n - m->r1, u, w;
+    unsigned int s = 0, j;
+
+    while ((r & 0x1) == 0) r >>= 1, s++;
+    /* r, s s.t. 2^s * r = n - 1, r in odd. */
+
+    if ((a %= n) == 0)
+        return (1);
+
+    for (u = one, w = mont128_to(m, a); r != 0; )
+    {
+        if ((r & 0x1) != 0)
+            u = mont128_mul(m, u, w); /* (mul-rdx) */
+
+        if ((r >>= 1) != 0)
+            w = mont128_mul(m, w, w); /* (sqr-rdx) */
+    }
+
+    if (u == one || u == neg)
+        return (1);
+
+    for (j = 1; j < s; j++)
+    {
+        u = mont128_mul(m, u, u); /* (sqr-rdx) */
+
+        if (u == neg)
+            return (1);
+        if (u == one) /* (n) is composite: */
+            return (0);
+    }
+
+    return (0);
+}
+
+/******************************************************************************/
+
+#endif /* MONT128_H_ */
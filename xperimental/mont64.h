@@ -0,0 +1,125 @@
+/******************************************************************************/
+
+/* Montgomery arithmetic for an odd, 64-bit modulus (n), with (R = 2^64).
+ * requires '__int128' extended type. */
+
+/* Copyright (c) 2020 Brett Hale.
+ * distributed under BSD-2-Clause license terms. see: mrtab.c */
+
+/******************************************************************************/
+
+#ifndef MONT64_H_
+#define MONT64_H_
+
+#include <stdint.h>
+
+#include "../sprpstat.h" /* (-DSPRP_STATS) instrumentation. */
+
+__extension__ typedef unsigned __int128 mont_u128;
+
+
+typedef struct mont64
+{
+    uint64_t n, ni; /* n, n^-1 (mod 2^64) */
+    uint64_t r1, r2; /* R (mod n), R^2 (mod n) */
+}
+mont64;
+
+/******************************************************************************/
+
+static inline void mont64_init (mont64 *m, uint64_t n)
+{
+    uint64_t ni = n; /* n * n = 1 (mod 2^3), for odd (n) */
+
+    /* assert(n > 1 && (n & 0x1) != 0); */
+
+    for (unsigned int i = 0; i < 5; i++)
+        ni *= 2 - n * ni; /* Newton: 2^6, 2^12, .. 2^96 */
+
+    m->n = n, m->ni = ni;
+    m->r1 = (- n) % n; /* (2^64 - n) mod n */
+    m->r2 = (uint64_t) (((mont_u128) m->r1 * m->r1) % n);
+}
+
+
+/* REDC(a * b), where: (a, b < n). the product (q * n) is subtracted
+ * rather than added, so there is no carry out for (n > 2^63) : */
+
+static inline uint64_t mont64_mul (const mont64 *m, uint64_t a, uint64_t b)
+{
+    mont_u128 t = (mont_u128) a * b;
+    uint64_t q = (uint64_t) t * m->ni, h, u;
+
+    h = (uint64_t) (((mont_u128) q * m->n) >> 64);
+    u = (uint64_t) (t >> 64);
+
+    return (u < h) ? (u - h + m->n) : (u - h);
+}
+
+
+static inline uint64_t mont64_to (const mont64 *m, uint64_t a)
+{
+    return mont64_mul(m, a % m->n, m->r2); /* a * R (mod n) */
+}
+
+static inline uint64_t mont64_from (const mont64 *m, uint64_t a)
+{
+    return mont64_mul(m, a, 1); /* a * R^-1 (mod n) */
+}
+
+/******************************************************************************/
+
+/* a-SPRP test for an odd (n > 2), in the Montgomery domain. a return
+ * value of (1) if (a = 0 mod n), as with prime64's sprp(). */
+
+static inline int mont64_sprp (const mont64 *m, uint64_t a)
+{
+    uint64_t n = m->n, r = n - 1, one = m->r1, neg = n - m->r1, u, w;
+    unsigned int s = 0, j;
+
+    while ((r & 0x1) == 0) r >>= 1, s++;
+    /* r, s s.t. 2^s * r = n - 1, r in odd. */
+
+    if ((a %= n) == 0)
+        return (1);
+
+    SPRP_STAT_ENTER(s);
+
+    for (u = one, w = mont64_to(m, a); r != 0; )
+    {
+        if ((r & 0x1) != 0)
+            u = mont64_mul(m, u, w), SPRP_STAT_MUL(); /* (mul-rdx) */
+
+        if ((r >>= 1) != 0)
+            w = mont64_mul(m, w, w), SPRP_STAT_MUL(); /* (sqr-rdx) */
+    }
+
+    if (u == one || u == neg)
+    {
+        SPRP_STAT_LEAVE((u == one) ? 0 : 1, 0);
+        return (1);
+    }
+
+    for (j = 1; j < s; j++)
+    {
+        u = mont64_mul(m, u, u), SPRP_STAT_MUL(); /* (sqr-rdx) */
+
+        if (u == neg)
+        {
+            SPRP_STAT_LEAVE(1, j);
+            return (1);
+        }
+        if (u == one) /* (n) is composite: */
+        {
+            SPRP_STAT_LEAVE(2, j);
+            return (0);
+        }
+    }
+
+    SPRP_STAT_LEAVE(3, s - 1);
+    return (0);
+}
+
+/******************************************************************************/
+
+#endif /* MONT64_H_ */
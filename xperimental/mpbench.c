@@ -0,0 +1,154 @@
+/******************************************************************************/
+
+/* mpbench : timing of the multi-precision Montgomery kernels (mpmont.h)
+ * for (512 .. 8192)-bit candidates. */
+
+/* requires '__int128' extended type. build with optimization, e.g.,
+ * 'cc -O3 -march=native', so the fixed-width kernels are unrolled. */
+
+/* Copyright (c) 2020 Brett Hale.
+ * distributed under BSD-2-Clause license terms. see: mrtab.c */
+
+/******************************************************************************/
+
+/* for each bit-length, the per-call time of: mp_mul (CIOS), mp_sqr, the
+ * per-candidate mp_init (R, R^2 mod n setup), and a single M-R round
+ * (mp_sprp) for a random, odd, full-width (n). the operations are chained
+ * so the results cannot be discarded. */
+
+/******************************************************************************/
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <time.h>
+
+#include "mpmont.h"
+
+MP_FIXED(512) MP_FIXED(1024) MP_FIXED(2048)
+MP_FIXED(3072) MP_FIXED(4096) MP_FIXED(8192)
+
+
+typedef struct mp_kern
+{
+    unsigned int bits;
+    void (*init) (mpmont *, const uint64_t *);
+    void (*mul) (uint64_t *, const uint64_t *, const uint64_t *,
+                 const mpmont *);
+    void (*sqr) (uint64_t *, const uint64_t *, const mpmont *);
+    int (*sprp) (const mpmont *, uint64_t);
+}
+mp_kern;
+
+#define MP_KERN(bits) \
+    { (bits), mp_init_##bits, mp_mul_##bits, mp_sqr_##bits, mp_sprp_##bits }
+
+static const mp_kern kern_tab[] =
+{
+    MP_KERN(512), MP_KERN(1024), MP_KERN(2048),
+    MP_KERN(3072), MP_KERN(4096), MP_KERN(8192)
+};
+
+/******************************************************************************/
+
+static uint64_t rng_next (uint64_t *x) /* (splitmix64) */
+{
+    uint64_t z = (*x += UINT64_C(0x9e3779b97f4a7c15));
+
+    z = (z ^ (z >> 30)) * UINT64_C(0xbf58476d1ce4e5b9);
+    z = (z ^ (z >> 27)) * UINT64_C(0x94d049bb133111eb);
+
+    return z ^ (z >> 31);
+}
+
+static double ns_per (clock_t c0, unsigned long cnt)
+{
+    return (double) (clock() - c0) * 1e9 / CLOCKS_PER_SEC / (double) cnt;
+}
+
+/******************************************************************************/
+
+int main (int argc, char **argv)
+{
+    static mpmont m;
+    static volatile uint64_t sink; /* (the chained results are used) */
+    uint64_t seed = 1, n[MP_LIMBS_MAX], a[MP_LIMBS_MAX], b[MP_LIMBS_MAX];
+    unsigned int ki, i, sel = 0;
+
+    if (argc > 1) /* (bits) option: */
+    {
+        for (ki = 0; ki < sizeof(kern_tab) / sizeof(kern_tab[0]); ki++)
+        {
+            char s[8];
+
+            sprintf(s, "%u", kern_tab[ki].bits);
+            for (i = 0; s[i] != 0 && s[i] == argv[1][i]; i++);
+            if (s[i] == 0 && argv[1][i] == 0) break;
+        }
+
+        if (ki == sizeof(kern_tab) / sizeof(kern_tab[0]))
+        {
+            fprintf(stderr, "usage: mpbench [bits], where: bits = "
+                    "512, 1024, 2048, 3072, 4096, 8192 (default: all)\n");
+            return (1);
+        }
+
+        sel = kern_tab[ki].bits;
+    }
+
+    fprintf(stdout, " bits :  mul (ns)   sqr (ns)  init (us)  "
+            "sprp (us)\n");
+
+    for (ki = 0; ki < sizeof(kern_tab) / sizeof(kern_tab[0]); ki++)
+    {
+        const mp_kern *kp = kern_tab + ki;
+        unsigned int nl = kp->bits / 64, pass = 0;
+        unsigned long cnt, j;
+        double t_mul, t_sqr, t_init, t_sprp;
+        clock_t c0;
+
+        if (sel != 0 && kp->bits != sel)
+            continue;
+
+        for (i = 0; i < nl; i++)
+            n[i] = rng_next(& seed);
+        n[0] |= 0x1, n[nl - 1] |= UINT64_C(1) << 63; /* odd, full-width */
+
+        kp->init(& m, n);
+
+        for (i = 0; i < nl; i++) /* (a, b < n) */
+            a[i] = m.r1[i], b[i] = m.r2[i];
+
+        /* scale the repetitions to ~(2^28) limb products per kernel: */
+
+        cnt = (1UL << 28) / ((unsigned long) nl * nl);
+
+        for (c0 = clock(), j = 0; j < cnt; j++)
+            kp->mul(a, a, b, & m);
+        t_mul = ns_per(c0, cnt);
+
+        for (c0 = clock(), j = 0; j < cnt; j++)
+            kp->sqr(b, b, & m);
+        t_sqr = ns_per(c0, cnt);
+
+        cnt = (1UL << 16) / nl;
+
+        for (c0 = clock(), j = 0; j < cnt; j++)
+            n[1] ^= a[j % nl], kp->init(& m, n);
+        t_init = ns_per(c0, cnt) * 1e-3;
+
+        cnt = (1UL << 16) / nl / nl + 1;
+
+        for (c0 = clock(), j = 0; j < cnt; j++)
+            pass += kp->sprp(& m, 2 + (j % 1024));
+        t_sprp = ns_per(c0, cnt) * 1e-3;
+
+        sink ^= a[0] ^ b[0] ^ pass;
+
+        fprintf(stdout, "%5u : %9.1f  %9.1f  %9.2f  %9.1f\n", kp->bits,
+                t_mul, t_sqr, t_init, t_sprp);
+    }
+
+    return (0);
+}
+
+/******************************************************************************/
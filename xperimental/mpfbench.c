@@ -0,0 +1,148 @@
+/******************************************************************************/
+
+/* mpfbench : small prime prefilter timing for (512 .. 8192)-bit random
+ * candidates. trial division by each odd prime < 2^12, vs. the block
+ * product / gcd filter (mpfilt.h). */
+
+/* requires '__int128' extended type. */
+
+/* Copyright (c) 2020 Brett Hale.
+ * distributed under BSD-2-Clause license terms. see: mrtab.c */
+
+/******************************************************************************/
+
+/* the candidates are classified first, and the rejected candidates and
+ * the survivors are timed separately: a rejected candidate usually has
+ * a small factor, and exits early; a survivor requires a full scan. */
+
+/******************************************************************************/
+
+#include <inttypes.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+
+#include "mpfilt.h"
+
+#define NCAND (4096)
+#define NLMAX (128)
+
+
+/* trial division, by a (64 : 64) remainder for each limb and prime: */
+
+static int td_test (const uint64_t *n, unsigned int nl)
+{
+    for (unsigned int i = 1; sp_lut[i] != 0; i++)
+    {
+        uint64_t p = sp_lut[i], r = 0;
+
+        for (unsigned int j = nl; j-- != 0; )
+            r = (uint64_t) ((((mpf_u128) r << 64) | n[j]) % p);
+
+        if (r == 0) /* composite: */
+            return (0);
+    }
+
+    return (1);
+}
+
+/******************************************************************************/
+
+static uint64_t rng_next (uint64_t *x) /* (splitmix64) */
+{
+    uint64_t z = (*x += UINT64_C(0x9e3779b97f4a7c15));
+
+    z = (z ^ (z >> 30)) * UINT64_C(0xbf58476d1ce4e5b9);
+    z = (z ^ (z >> 27)) * UINT64_C(0x94d049bb133111eb);
+
+    return z ^ (z >> 31);
+}
+
+static double ns_per (clock_t c0, unsigned long cnt)
+{
+    return (cnt == 0) ? (0.0) :
+        (double) (clock() - c0) * 1e9 / CLOCKS_PER_SEC / (double) cnt;
+}
+
+/******************************************************************************/
+
+int main (void)
+{
+    const unsigned int bits[] = {512, 1024, 2048, 3072, 4096, 8192, 0};
+    uint64_t seed = 1, *cand = malloc(sizeof(uint64_t) * NCAND * NLMAX);
+    unsigned int *rej = malloc(sizeof(unsigned int) * NCAND);
+    static volatile unsigned int sink;
+    unsigned int i;
+
+    if (cand == NULL || rej == NULL)
+        return (1);
+
+    mpf_init();
+
+    for (i = 0; mpf_tab[i].d != 0; i++);
+
+    fprintf(stdout, "%u block products for the %u odd primes < 2^12\n\n",
+            i, (unsigned int) (sizeof(sp_lut) / sizeof(sp_lut[0]) - 2));
+
+    fprintf(stdout, " bits :  rejected  : trial (ns)  block (ns) :  "
+            "survivor : trial (ns)  block (ns)\n");
+
+    for (const unsigned int *bp = bits; *bp != 0; bp++)
+    {
+        unsigned int nl = *bp / 64, j, pass;
+        double t_td[2], t_bk[2];
+
+        for (i = 0; i < NCAND; i++)
+        {
+            uint64_t *n = cand + i * NLMAX;
+
+            for (j = 0; j < nl; j++)
+                n[j] = rng_next(& seed);
+            n[0] |= 0x1, n[nl - 1] |= UINT64_C(1) << 63;
+
+            rej[i] = !td_test(n, nl);
+
+            if ((int) rej[i] == mpf_test(n, nl)) /* (must agree) */
+            {
+                fprintf(stderr, "mpfbench: filter mismatch\n");
+                return (1);
+            }
+        }
+
+        for (pass = 0; pass < 2; pass++) /* rejected, survivors: */
+        {
+            unsigned long cnt = 0, reps = (1UL << 20) / nl / NCAND + 1, r;
+            clock_t c0;
+
+            for (i = 0; i < NCAND; i++)
+                cnt += (rej[i] != pass);
+            cnt *= reps;
+
+            for (c0 = clock(), r = 0; r < reps; r++)
+                for (i = 0; i < NCAND; i++)
+                    if (rej[i] != pass)
+                        sink += td_test(cand + i * NLMAX, nl);
+            t_td[pass] = ns_per(c0, cnt);
+
+            for (c0 = clock(), r = 0; r < reps; r++)
+                for (i = 0; i < NCAND; i++)
+                    if (rej[i] != pass)
+                        sink += mpf_test(cand + i * NLMAX, nl);
+            t_bk[pass] = ns_per(c0, cnt);
+        }
+
+        for (pass = 0, i = 0; i < NCAND; i++)
+            pass += rej[i];
+
+        fprintf(stdout, "%5u :  %.4f  : %10.1f  %10.1f  :  %.4f  "
+                ": %10.1f  %10.1f\n", *bp, (double) pass / NCAND,
+                t_td[0], t_bk[0], 1.0 - (double) pass / NCAND,
+                t_td[1], t_bk[1]);
+    }
+
+    free(rej), free(cand);
+
+    return (0);
+}
+
+/******************************************************************************/
@@ -0,0 +1,129 @@
+/******************************************************************************/
+
+/* small prime prefilter for multi-precision candidates: the odd primes
+ * in sp_lut (< 2^12) are packed into 64-bit block products. a candidate
+ * is reduced once per block, without division, and the word-size result
+ * is tested for each prime in the block with a multiplicative inverse.
+ * requires '__int128' extended type. */
+
+/* Copyright (c) 2020 Brett Hale.
+ * distributed under BSD-2-Clause license terms. see: mrtab.c */
+
+/******************************************************************************/
+
+/* for an odd block product (d), with (di = d^-1 mod 2^64), the 'exact
+ * division' remainder of an (nl)-limb value (a) is computed one limb at
+ * a time, with two multiplies and no division (cf. GMP's 'modexact'):
+
+ * r * 2^(64 * nl) = - a (mod d), (0 <= r <= d)
+
+ * (r) is not (a mod d); but since gcd(2, d) = 1, gcd(r, d) = gcd(a, d),
+ * so (a) has a prime factor in the block iff: gcd(r, d) > 1. there are
+ * 100 blocks for the 563 odd primes < 2^12, and each block costs (nl)
+ * limb steps, rather than (nl) limb divisions for each prime.
+
+ * a single-word gcd costs dozens of divisions. instead, for each prime
+ * (p) in the block, with (pi = p^-1 mod 2^64), (p | r) iff:
+ * (r * pi mod 2^64) <= floor((2^64 - 1) / p). [Granlund, Montgomery] */
+
+/******************************************************************************/
+
+#ifndef MP_FILT_H_
+#define MP_FILT_H_
+
+#include <stdint.h>
+
+#include "../spk12.h" /* small prime LUT. */
+
+__extension__ typedef unsigned __int128 mpf_u128;
+
+#define MPF_BLOCKS (128)
+#define MPF_PRIMES (564)
+
+
+typedef struct mpf_blk
+{
+    uint64_t d, di; /* block product (d), d^-1 (mod 2^64) */
+    unsigned int p0, p1; /* primes: {p0 .. p1 - 1} in mpf_pi */
+}
+mpf_blk;
+
+static mpf_blk mpf_tab[MPF_BLOCKS + 1]; /* EOT entry: (d = 0) */
+static uint64_t mpf_pi[MPF_PRIMES][2]; /* p^-1 (mod 2^64), (2^64 - 1) / p */
+
+static inline uint64_t mpf_inv (uint64_t d) /* (d) odd : */
+{
+    uint64_t di = d; /* d * d = 1 (mod 2^3) */
+
+    for (unsigned int i = 0; i < 5; i++)
+        di *= 2 - d * di; /* Newton: 2^6, 2^12, .. 2^96 */
+
+    return di;
+}
+
+/******************************************************************************/
+
+static void mpf_init (void)
+{
+    uint64_t d = 1;
+    unsigned int i, nb = 0;
+
+    for (i = 1; sp_lut[i] != 0; i++) /* odd primes: */
+    {
+        uint64_t p = sp_lut[i];
+
+        if (d > UINT64_MAX / p) /* (block is full) */
+        {
+            mpf_tab[nb].d = d, mpf_tab[nb].p1 = i - 1;
+            mpf_tab[++nb].p0 = i - 1, d = 1;
+        }
+
+        d *= p;
+        mpf_pi[i - 1][0] = mpf_inv(p), mpf_pi[i - 1][1] = UINT64_MAX / p;
+    }
+
+    mpf_tab[nb].d = d, mpf_tab[nb].p1 = i - 1;
+    mpf_tab[++nb].d = 0;
+
+    for (i = 0; i < nb; i++)
+        mpf_tab[i].di = mpf_inv(mpf_tab[i].d);
+}
+
+
+static inline uint64_t mpf_rem (const uint64_t *a, unsigned int nl,
+                                const mpf_blk *b)
+{
+    uint64_t c = 0;
+
+    for (unsigned int i = 0; i < nl; i++)
+    {
+        uint64_t s = a[i], x = s - c;
+
+        c = (x > s); /* (borrow) */
+        x *= b->di;
+        c += (uint64_t) (((mpf_u128) x * b->d) >> 64);
+    }
+
+    return c;
+}
+
+/******************************************************************************/
+
+/* return (0) if an odd (n > 2^12) has a prime factor < 2^12 : */
+
+static inline int mpf_test (const uint64_t *n, unsigned int nl)
+{
+    for (const mpf_blk *b = mpf_tab; b->d != 0; b++)
+    {
+        uint64_t r = mpf_rem(n, nl, b);
+
+        for (unsigned int i = b->p0; i < b->p1; i++)
+            if (r * mpf_pi[i][0] <= mpf_pi[i][1]) return (0);
+    }
+
+    return (1);
+}
+
+/******************************************************************************/
+
+#endif /* MP_FILT_H_ */
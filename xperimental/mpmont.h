@@ -0,0 +1,376 @@
+/******************************************************************************/
+
+/* fixed-width, multi-precision Montgomery arithmetic for an odd modulus
+ * of (nl) 64-bit limbs (little-endian), (R = 2^(64 * nl)), up to 8192
+ * bits. requires '__int128' extended type. */
+
+/* Copyright (c) 2020 Brett Hale.
+ * distributed under BSD-2-Clause license terms. see: mrtab.c */
+
+/******************************************************************************/
+
+/* [6] C.K. Koc, T. Acar, B.S. Kaliski Jr., "Analyzing and Comparing
+ * Montgomery Multiplication Algorithms". IEEE Micro, Vol. 16, Jun. 1996,
+ * pp. 26-33. (CIOS : coarsely integrated operand scanning) */
+
+/* the limb count is a parameter of each function, rather than a member
+ * of the context, so that a call with a constant (nl) - e.g., from the
+ * MP_FIXED wrappers - can be specialized by the compiler, with the inner
+ * loops fully unrolled (-O3 performs the constant propagation). */
+
+/******************************************************************************/
+
+#ifndef MP_MONT_H_
+#define MP_MONT_H_
+
+#include <stdint.h>
+
+#include "expwin.h" /* sliding-window exponentiation. */
+
+__extension__ typedef unsigned __int128 mp_u128;
+
+#define MP_LIMBS_MAX (128) /* (8192) bits */
+
+
+typedef struct mpmont
+{
+    uint64_t n[MP_LIMBS_MAX]; /* modulus (n), odd. */
+    uint64_t r1[MP_LIMBS_MAX]; /* R (mod n) */
+    uint64_t r2[MP_LIMBS_MAX]; /* R^2 (mod n) */
+    uint64_t ni; /* -n^-1 (mod 2^64) */
+}
+mpmont;
+
+/******************************************************************************/
+
+/* r = a - b, returning the borrow: */
+
+static inline uint64_t mp_sub (uint64_t *r, const uint64_t *a,
+                               const uint64_t *b, unsigned int nl)
+{
+    uint64_t c = 0;
+
+    for (unsigned int i = 0; i < nl; i++)
+    {
+        mp_u128 d = (mp_u128) a[i] - b[i] - c;
+        r[i] = (uint64_t) d, c = (uint64_t) (d >> 64) & 0x1;
+    }
+
+    return c;
+}
+
+/* return (1) if (a >= b) : */
+
+static inline int mp_geq (const uint64_t *a, const uint64_t *b,
+                          unsigned int nl)
+{
+    for (unsigned int i = nl; i-- != 0; )
+        if (a[i] != b[i]) return (a[i] > b[i]);
+
+    return (1);
+}
+
+static inline int mp_eq (const uint64_t *a, const uint64_t *b,
+                         unsigned int nl)
+{
+    uint64_t d = 0;
+
+    for (unsigned int i = 0; i < nl; i++)
+        d |= a[i] ^ b[i];
+
+    return (d == 0);
+}
+
+
+/* a = 2 * a (mod n), for (a < n) : */
+
+static inline void mp_dbl_mod (uint64_t *a, const uint64_t *n,
+                               unsigned int nl)
+{
+    uint64_t c = 0;
+
+    for (unsigned int i = 0; i < nl; i++)
+    {
+        uint64_t x = a[i];
+        a[i] = (x << 1) | c, c = x >> 63;
+    }
+
+    if (c != 0 || mp_geq(a, n, nl))
+        mp_sub(a, a, n, nl);
+}
+
+/******************************************************************************/
+
+/* CIOS : r = a * b * R^-1 (mod n), for (a, b < n). (r) may alias (a) or
+ * (b). the running sum (t) is (nl + 2) limbs: */
+
+static inline void mp_mul (uint64_t *r, const uint64_t *a, const uint64_t *b,
+                           const mpmont *m, unsigned int nl)
+{
+    const uint64_t *n = m->n;
+    uint64_t t[MP_LIMBS_MAX + 2], c, q;
+    unsigned int i, j;
+
+    for (i = 0; i < nl + 2; i++)
+        t[i] = 0;
+
+    for (i = 0; i < nl; i++)
+    {
+        mp_u128 x;
+        uint64_t bi = b[i];
+
+        for (c = 0, j = 0; j < nl; j++) /* t += a * b[i] : */
+        {
+            x = (mp_u128) a[j] * bi + t[j] + c;
+            t[j] = (uint64_t) x, c = (uint64_t) (x >> 64);
+        }
+
+        x = (mp_u128) t[nl] + c;
+        t[nl] = (uint64_t) x, t[nl + 1] = (uint64_t) (x >> 64);
+
+        q = t[0] * m->ni; /* t = (t + q * n) / 2^64 : */
+
+        x = (mp_u128) q * n[0] + t[0];
+        c = (uint64_t) (x >> 64);
+
+        for (j = 1; j < nl; j++)
+        {
+            x = (mp_u128) q * n[j] + t[j] + c;
+            t[j - 1] = (uint64_t) x, c = (uint64_t) (x >> 64);
+        }
+
+        x = (mp_u128) t[nl] + c;
+        t[nl - 1] = (uint64_t) x;
+        t[nl] = t[nl + 1] + (uint64_t) (x >> 64);
+    }
+
+    if (t[nl] != 0 || mp_geq(t, n, nl)) /* (t < 2n) */
+        mp_sub(t, t, n, nl);
+
+    for (j = 0; j < nl; j++)
+        r[j] = t[j];
+}
+
+
+/* r = a^2 * R^-1 (mod n). the (2 * nl) limb square is formed from the
+ * (nl * (nl - 1) / 2) distinct cross products, doubled, plus the (nl)
+ * diagonal terms. it is then reduced by separated operand scanning, for
+ * roughly (1.5 * nl^2) limb products rather than (2 * nl^2) : */
+
+static inline void mp_sqr (uint64_t *r, const uint64_t *a, const mpmont *m,
+                           unsigned int nl)
+{
+    const uint64_t *n = m->n;
+    uint64_t t[2 * MP_LIMBS_MAX + 1], c, q;
+    unsigned int i, j;
+    mp_u128 x;
+
+    for (i = 0; i <= 2 * nl; i++)
+        t[i] = 0;
+
+    for (i = 0; i < nl; i++) /* cross products: a[i] * a[j], j > i */
+    {
+        uint64_t ai = a[i];
+
+        for (c = 0, j = i + 1; j < nl; j++)
+        {
+            x = (mp_u128) ai * a[j] + t[i + j] + c;
+            t[i + j] = (uint64_t) x, c = (uint64_t) (x >> 64);
+        }
+
+        t[i + nl] = c;
+    }
+
+    for (c = 0, i = 0; i < 2 * nl; i++) /* (doubled) */
+    {
+        uint64_t ti = t[i];
+        t[i] = (ti << 1) | c, c = ti >> 63;
+    }
+
+    for (c = 0, i = 0; i < nl; i++) /* diagonal terms: */
+    {
+        x = (mp_u128) a[i] * a[i] + t[2 * i] + c;
+        t[2 * i] = (uint64_t) x;
+
+        x = (mp_u128) t[2 * i + 1] + (uint64_t) (x >> 64);
+        t[2 * i + 1] = (uint64_t) x, c = (uint64_t) (x >> 64);
+    }
+
+    for (i = 0; i < nl; i++) /* reduction: t = t + q * n * 2^(64i) */
+    {
+        q = t[i] * m->ni;
+
+        for (c = 0, j = 0; j < nl; j++)
+        {
+            x = (mp_u128) q * n[j] + t[i + j] + c;
+            t[i + j] = (uint64_t) x, c = (uint64_t) (x >> 64);
+        }
+
+        for (j = i + nl; c != 0 && j <= 2 * nl; j++)
+        {
+            x = (mp_u128) t[j] + c;
+            t[j] = (uint64_t) x, c = (uint64_t) (x >> 64);
+        }
+    }
+
+    if (t[2 * nl] != 0 || mp_geq(t + nl, n, nl)) /* (t < 2n) */
+        mp_sub(t + nl, t + nl, n, nl);
+
+    for (j = 0; j < nl; j++)
+        r[j] = t[nl + j];
+}
+
+/******************************************************************************/
+
+/* set up the context for an odd (n), once per candidate. R (mod n) and
+ * R^2 (mod n) are found by modular doubling; for large (nl), the cost
+ * is small relative to a single exponentiation. */
+
+static inline void mp_init (mpmont *m, const uint64_t *n, unsigned int nl)
+{
+    uint64_t ni = n[0]; /* n * n = 1 (mod 2^3), for odd (n) */
+    unsigned int i;
+
+    for (i = 0; i < 5; i++)
+        ni *= 2 - n[0] * ni; /* Newton: 2^6, 2^12, .. 2^96 */
+
+    m->ni = - ni;
+
+    for (i = 0; i < nl; i++)
+        m->n[i] = n[i], m->r1[i] = 0;
+
+    m->r1[0] = 1; /* (n > 1) */
+
+    for (i = 0; i < 64 * nl; i++)
+        mp_dbl_mod(m->r1, n, nl);
+
+    for (i = 0; i < nl; i++)
+        m->r2[i] = m->r1[i];
+
+    for (i = 0; i < 64 * nl; i++)
+        mp_dbl_mod(m->r2, n, nl);
+}
+
+/******************************************************************************/
+
+/* u = a^e (mod n), in the Montgomery domain, for a nonzero (ne)-limb
+ * exponent (e); (u) may alias (a). left-to-right sliding-window
+ * exponentiation (see: expwin.h) : */
+
+static inline void mp_pow (uint64_t *u, const uint64_t *a, const uint64_t *e,
+                           unsigned int ne, const mpmont *m, unsigned int nl)
+{
+    uint64_t x[MP_LIMBS_MAX], g[EW_TAB][MP_LIMBS_MAX];
+    unsigned int i, j, w, l, v;
+
+    for (j = 0; j < nl; j++)
+        g[0][j] = a[j];
+
+    /* odd powers: g[v] = a^(2v + 1) (mod n), v < 2^(w - 1) */
+
+    i = ew_bits(e, ne) - 1, w = ew_width(i + 1);
+
+    if (w > 1)
+        mp_sqr(x, g[0], m, nl); /* (sqr-rdx) */
+
+    for (v = 1; v < (1U << (w - 1)); v++)
+        mp_mul(g[v], g[v - 1], x, m, nl); /* (mul-rdx) */
+
+    v = ew_window(e, i, w, & l);
+
+    for (j = 0; j < nl; j++)
+        u[j] = g[v >> 1][j];
+
+    while (l-- != 0)
+    {
+        if (ew_bit(e, (i = l)) == 0)
+        {
+            mp_sqr(u, u, m, nl); /* (sqr-rdx) */
+            continue;
+        }
+
+        for (v = ew_window(e, i, w, & l), i -= l - 1; i != 0; i--)
+            mp_sqr(u, u, m, nl); /* (sqr-rdx) */
+
+        mp_mul(u, u, g[v >> 1], m, nl); /* (mul-rdx) */
+    }
+}
+
+
+/* a-SPRP test for an odd (n > 3), with a single-word base (a), where
+ * (1 < a < n - 1). a sequence of these calls shares the context, so the
+ * R^2 (mod n) setup is performed once per candidate, for all rounds. */
+
+static inline int mp_sprp (const mpmont *m, uint64_t a, unsigned int nl)
+{
+    uint64_t r[MP_LIMBS_MAX], u[MP_LIMBS_MAX], x[MP_LIMBS_MAX];
+    uint64_t neg[MP_LIMBS_MAX];
+    unsigned int s = 0, i, j;
+
+    /* r, s s.t. 2^s * r = n - 1, r in odd : */
+
+    for (i = 0; i < nl; i++)
+        r[i] = m->n[i];
+
+    r[0] ^= 0x1; /* (n - 1) */
+
+    for (i = 0; r[i] == 0; i++)
+        s += 64;
+
+    for (x[0] = r[i]; (x[0] & 0x1) == 0; x[0] >>= 1)
+        s++;
+
+    for (i = 0; i < nl; i++) /* r = (n - 1) >> s : */
+    {
+        unsigned int q = s / 64, b = s % 64;
+        uint64_t lo = (i + q < nl) ? r[i + q] : 0;
+        uint64_t hi = (i + q + 1 < nl) ? r[i + q + 1] : 0;
+
+        r[i] = (b == 0) ? lo : (lo >> b) | (hi << (64 - b));
+    }
+
+    for (i = 0; i < nl; i++) /* x = a * R (mod n) : */
+        x[i] = 0;
+    x[0] = a;
+    mp_mul(x, x, m->r2, m, nl);
+
+    mp_sub(neg, m->n, m->r1, nl); /* -R (mod n) */
+
+    mp_pow(u, x, r, nl, m, nl); /* u = a^r */
+
+    if (mp_eq(u, m->r1, nl) || mp_eq(u, neg, nl))
+        return (1);
+
+    for (j = 1; j < s; j++)
+    {
+        mp_sqr(u, u, m, nl); /* (sqr-rdx) */
+
+        if (mp_eq(u, neg, nl))
+            return (1);
+        if (mp_eq(u, m->r1, nl)) /* (n) is composite: */
+            return (0);
+    }
+
+    return (0);
+}
+
+/******************************************************************************/
+
+/* fixed-width entry points: e.g., MP_FIXED(2048) defines mp_init_2048,
+ * mp_mul_2048, mp_sqr_2048, and mp_sprp_2048, with a constant (nl) : */
+
+#define MP_FIXED(bits) \
+    static inline void mp_init_##bits (mpmont *m, const uint64_t *n) \
+    { mp_init(m, n, (bits) / 64); } \
+    static inline void mp_mul_##bits (uint64_t *r, const uint64_t *a, \
+                                      const uint64_t *b, const mpmont *m) \
+    { mp_mul(r, a, b, m, (bits) / 64); } \
+    static inline void mp_sqr_##bits (uint64_t *r, const uint64_t *a, \
+                                      const mpmont *m) \
+    { mp_sqr(r, a, m, (bits) / 64); } \
+    static inline int mp_sprp_##bits (const mpmont *m, uint64_t a) \
+    { return mp_sprp(m, a, (bits) / 64); }
+
+/******************************************************************************/
+
+#endif /* MP_MONT_H_ */
@@ -0,0 +1,129 @@
+/******************************************************************************/
+
+/* mppbench : provable prime generation (mpprov.h) vs. the probable prime
+ * search, for (256 .. 2048)-bit primes. the M-R iterations are taken from
+ * a threshold table written by mrtab, e.g., 'mrtab 128 | mppbench' */
+
+/* requires '__int128' extended type. */
+
+/* Copyright (c) 2020 Brett Hale.
+ * distributed under BSD-2-Clause license terms. see: mrtab.c */
+
+/******************************************************************************/
+
+/* the probable prime search: a random odd k-bit candidate is rejected by
+ * the small prime prefilter (mpfilt.h), or by a base-2 M-R round; a
+ * candidate that passes is given (t - 1) further rounds, with (t) from the
+ * table, s.t. p(k, t) <= 2^-s. the provable prime construction has the
+ * same prefilter, and a single exponentiation per candidate at each level
+ * of the recursion, but no further rounds. the search cost is about the
+ * same for both, so the difference is largely (t - 1) M-R rounds, vs. the
+ * lower levels of the construction. */
+
+/******************************************************************************/
+
+#include <inttypes.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+
+#include "mpprov.h"
+
+#define TMAX (1024 / 2 + 2)
+
+
+/* read the threshold table (lut) and (s) from mrtab's output. return the
+ * number of entries, including the EOT entry, or (0) on error: */
+
+static unsigned int lut_read (FILE *f, unsigned int *lut, unsigned int *s)
+{
+    unsigned int n = 0;
+    int c;
+
+    if (fscanf(f, "k from t = 2 (k > 16) s.t. p(k, t) <= 2^-%u", s) != 1)
+        return (0);
+
+    while ((c = fgetc(f)) != EOF && c != ':'); /* (end of header) */
+
+    while (n < TMAX && fscanf(f, " %x ,", lut + n) == 1)
+        if (lut[n++] == 0) return (n);
+
+    return (0);
+}
+
+static double sec (clock_t c0)
+{
+    return (double) (clock() - c0) / CLOCKS_PER_SEC;
+}
+
+/******************************************************************************/
+
+int main (void)
+{
+    static const unsigned int bits[] = {256, 512, 1024, 2048, 0};
+    static unsigned int lut[TMAX];
+    static mpmont m;
+
+    uint64_t seed = 1, n[MP_LIMBS_MAX];
+    unsigned int s, bi;
+
+    if (lut_read(stdin, lut, & s) == 0)
+    {
+        fprintf(stderr, "usage: mrtab [s] | mppbench\n");
+        return (1);
+    }
+
+    mpf_init();
+
+    fprintf(stdout, "s = %u\n bits :  t : probable (ms)  provable (ms)  "
+            "ratio\n", s);
+
+    for (bi = 0; bits[bi] != 0; bi++)
+    {
+        unsigned int k = bits[bi], nl = k / 64, np = 256 * 256 / k, i, t;
+        double t_pp, t_pv;
+        clock_t c0;
+
+        for (t = 1; k <= lut[t - 1]; t++); /* M-R iterations: */
+
+        for (c0 = clock(), i = 0; i < np; i++)
+        {
+            unsigned int j;
+
+            for (;;) /* probable prime search: */
+            {
+                for (j = 0; j < nl; j++)
+                    n[j] = mpp_rng(& seed);
+                n[0] |= 0x1, n[nl - 1] |= UINT64_C(1) << 63;
+
+                if (!mpf_test(n, nl))
+                    continue;
+
+                mp_init(& m, n, nl);
+
+                if (mp_sprp(& m, 2, nl))
+                    break;
+            }
+
+            for (j = 1; j < t; j++) /* (bases: 3, 4, ..) */
+                if (!mp_sprp(& m, 2 + j, nl)) break;
+
+            if (j < t) /* (a base-2 strong liar) */
+                i--;
+        }
+
+        t_pp = sec(c0) * 1e3 / np;
+
+        for (c0 = clock(), i = 0; i < np; i++)
+            mpp_gen(n, k, & seed);
+
+        t_pv = sec(c0) * 1e3 / np;
+
+        fprintf(stdout, "%5u : %2u : %13.2f  %13.2f  %5.2f\n", k, t,
+                t_pp, t_pv, t_pv / t_pp);
+    }
+
+    return (0);
+}
+
+/******************************************************************************/
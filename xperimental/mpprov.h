@@ -0,0 +1,236 @@
+/******************************************************************************/
+
+/* provable prime generation, with the multi-precision kernels (mpmont.h):
+ * a random k-bit prime is constructed from a smaller prime (q), which is
+ * itself constructed, and certified, in the same way. requires '__int128'
+ * extended type. */
+
+/* [8] J. Shawe-Taylor, "Generating strong primes". Electronics Letters,
+ * Vol. 22, Jul. 1986, pp. 875-877. (cf. HAC.4.62, FIPS 186-4 C.6) */
+
+/* Copyright (c) 2020 Brett Hale.
+ * distributed under BSD-2-Clause license terms. see: mrtab.c */
+
+/******************************************************************************/
+
+/* Pocklington's theorem, for a single prime factor of (n - 1) : if there
+ * is a prime (q | n - 1), with q > sqrt(n) - 1, and a base (a) s.t.
+
+ * a^(n - 1) = 1 (mod n), and: gcd(a^((n - 1) / q) - 1, n) = 1,
+
+ * then (n) is prime. [HAC.4.40]
+
+ * given a certified prime (q), with (kq = ceil(k / 2) + 1) bits, so that:
+ * q >= 2^ceil(k / 2) > sqrt(n), the candidates are: n = 2 * r * q + 1,
+ * with a random (r), and n in [2^(k - 1), 2^k). a candidate that passes
+ * trial division (mpfilt.h) requires a single exponentiation, as for a
+ * M-R round: x = a^(2r), then: x^q = 1, and: gcd(x - 1, n) = 1. for
+ * (k <= 64), the prime is found with the deterministic is_prime_u64().
+
+ * with (a = 2), a prime (n) fails the gcd condition only if x = 1; that
+ * is, with probability ~ (1 / q). such a candidate is simply rejected. */
+
+/******************************************************************************/
+
+#ifndef MP_PROV_H_
+#define MP_PROV_H_
+
+#include <stdint.h>
+
+#include "mpmont.h" /* multi-precision Montgomery kernels. */
+#include "mpfilt.h" /* small prime prefilter. */
+#include "prime64.h" /* is_prime_u64() */
+
+
+static inline uint64_t mpp_rng (uint64_t *x) /* (splitmix64) */
+{
+    uint64_t z = (*x += UINT64_C(0x9e3779b97f4a7c15));
+
+    z = (z ^ (z >> 30)) * UINT64_C(0xbf58476d1ce4e5b9);
+    z = (z ^ (z >> 27)) * UINT64_C(0x94d049bb133111eb);
+
+    return z ^ (z >> 31);
+}
+
+/******************************************************************************/
+
+/* r = a * b, with (na + nb) limbs. (r) may not alias (a) or (b) : */
+
+static inline void mpp_mul (uint64_t *r, const uint64_t *a, unsigned int na,
+                            const uint64_t *b, unsigned int nb)
+{
+    unsigned int i, j;
+
+    for (i = 0; i < na + nb; i++)
+        r[i] = 0;
+
+    for (i = 0; i < na; i++)
+    {
+        uint64_t c = 0;
+
+        for (j = 0; j < nb; j++)
+        {
+            mp_u128 t = (mp_u128) a[i] * b[j] + r[i + j] + c;
+            r[i + j] = (uint64_t) t, c = (uint64_t) (t >> 64);
+        }
+
+        r[i + nb] = c;
+    }
+}
+
+/* a = a >> b, for a nonzero (a), where (b) is the number of trailing
+ * zero bits; i.e., (a) is made odd : */
+
+static inline void mpp_odd (uint64_t *a, unsigned int nl)
+{
+    unsigned int q, b, i;
+    uint64_t x;
+
+    for (q = 0; a[q] == 0; q++);
+    for (b = 0, x = a[q]; (x & 0x1) == 0; x >>= 1) b++;
+
+    for (i = 0; i + q < nl; i++)
+    {
+        uint64_t hi = (i + q + 1 < nl) ? a[i + q + 1] : 0;
+        a[i] = (b == 0) ? a[i + q] : (a[i + q] >> b) | (hi << (64 - b));
+    }
+
+    for (; i < nl; i++)
+        a[i] = 0;
+}
+
+/* return (1) if gcd(x, n) = 1, for an odd (n), and (x < n). binary gcd,
+ * with the even factors of (x) removed, since (n) is odd: */
+
+static inline int mpp_coprime (const uint64_t *x, const uint64_t *n,
+                               unsigned int nl)
+{
+    uint64_t u[MP_LIMBS_MAX], v[MP_LIMBS_MAX], *a = u, *b = v, z = 0;
+    unsigned int i;
+
+    for (i = 0; i < nl; i++)
+        u[i] = x[i], v[i] = n[i], z |= x[i];
+
+    if (z == 0) /* gcd(0, n) = n */
+        return (0);
+
+    for (;;) /* (b) is odd : */
+    {
+        mpp_odd(a, nl);
+
+        if (mp_eq(a, b, nl)) /* gcd(x, n) = a */
+        {
+            for (z = a[0] ^ 0x1, i = 1; i < nl; i++) z |= a[i];
+            return (z == 0);
+        }
+
+        if (!mp_geq(a, b, nl)) /* a = |a - b|, b = min(a, b) : */
+        {
+            uint64_t *t = a;
+            a = b, b = t;
+        }
+
+        mp_sub(a, a, b, nl);
+    }
+}
+
+/******************************************************************************/
+
+/* Pocklington test of: n = r2 * q + 1, with (r2 = 2r), given the context
+ * for (n). return (1) if (n) is proven prime, (0) otherwise: */
+
+static inline int mpp_pocklington (const mpmont *m, const uint64_t *r2,
+                                   unsigned int nr, const uint64_t *q,
+                                   unsigned int nq, unsigned int nl)
+{
+    uint64_t x[MP_LIMBS_MAX], y[MP_LIMBS_MAX], one[MP_LIMBS_MAX];
+    unsigned int i;
+
+    for (i = 0; i < nl; i++) /* (a = 2) */
+        one[i] = 0, x[i] = m->r1[i];
+
+    mp_dbl_mod(x, m->n, nl);
+
+    mp_pow(x, x, r2, nr, m, nl); /* x = a^(2r) */
+    mp_pow(y, x, q, nq, m, nl); /* y = a^(n - 1) */
+
+    if (!mp_eq(y, m->r1, nl)) /* (n) is composite: */
+        return (0);
+
+    one[0] = 1;
+    mp_mul(x, x, one, m, nl); /* (from the Montgomery domain) */
+
+    for (i = 0; x[i]-- == 0; i++); /* x = x - 1, (x != 0) */
+
+    return mpp_coprime(x, m->n, nl);
+}
+
+/******************************************************************************/
+
+/* a random, proven k-bit prime (p), for (33 <= k <= 64 * MP_LIMBS_MAX).
+ * mpf_init() must be called first. return the number of limbs in (p) : */
+
+static unsigned int mpp_gen (uint64_t *p, unsigned int k, uint64_t *seed)
+{
+    uint64_t q[MP_LIMBS_MAX], r2[MP_LIMBS_MAX], t[2 * MP_LIMBS_MAX];
+    unsigned int kq = (k + 1) / 2 + 1, kr = k - kq, nl = (k + 63) / 64;
+    unsigned int nq, nr = (kr + 64) / 64, i;
+    mpmont m;
+
+    if (k <= 64) /* deterministic test: */
+    {
+        uint64_t n;
+
+        do
+        {
+            n = mpp_rng(seed) >> (64 - k);
+            n |= (UINT64_C(1) << (k - 1)) | 0x1;
+        }
+        while (!is_prime_u64(n));
+
+        p[0] = n;
+        return (1);
+    }
+
+    nq = mpp_gen(q, kq, seed);
+
+    for (;;)
+    {
+        /* r2 = 2r in: [0, 2^(kr + 1)), so: 2rq < 2^(k + 1). the values
+         * in: [2^(k - 1), 2^k) are accepted, with a probability of
+         * (2^(kq - 1) / q) in: (1/4, 1/2], for: q in [2^(kq - 1), 2^kq) */
+
+        for (i = 0; i < nr; i++)
+            r2[i] = mpp_rng(seed);
+
+        r2[0] &= ~ UINT64_C(1);
+        r2[nr - 1] &= ((kr + 1) % 64) ? (UINT64_C(1) << ((kr + 1) % 64)) - 1
+            : ~ UINT64_C(0);
+
+        mpp_mul(t, r2, nr, q, nq);
+
+        for (i = nr + nq; i > nl && t[i - 1] == 0; i--);
+
+        if (i > nl || (t[nl - 1] >> ((k - 1) % 64)) != 1)
+            continue; /* (not a k-bit value) */
+
+        t[0] |= 0x1; /* n = 2rq + 1 */
+
+        if (!mpf_test(t, nl))
+            continue;
+
+        mp_init(& m, t, nl);
+
+        if (mpp_pocklington(& m, r2, nr, q, nq, nl))
+            break;
+    }
+
+    for (i = 0; i < nl; i++)
+        p[i] = t[i];
+
+    return nl;
+}
+
+/******************************************************************************/
+
+#endif /* MP_PROV_H_ */
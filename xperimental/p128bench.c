@@ -0,0 +1,134 @@
+/******************************************************************************/
+
+/* p128bench : the prime128.h BPSW test vs. the prime64.h M-R test. */
+
+/* requires '__int128' extended type. */
+
+/* Copyright (c) 2020 Brett Hale.
+ * distributed under BSD-2-Clause license terms. see: mrtab.c */
+
+/******************************************************************************/
+
+/* two input sets of (NVAL) values for each size: random odd values, which
+ * are mostly rejected by trial division or the base-2 round; and primes,
+ * which require every round. the 64-bit values are tested by both paths,
+ * with BPSW forced through the 128-bit arithmetic, and the results must
+ * match. the 96 and 128-bit values show the cost of the wider modulus. */
+
+/******************************************************************************/
+
+#include <inttypes.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+
+#include "prime128.h"
+
+#define NVAL (1 << 14)
+
+
+static uint64_t rng_next (uint64_t *x) /* (splitmix64) */
+{
+    uint64_t z = (*x += UINT64_C(0x9e3779b97f4a7c15));
+
+    z = (z ^ (z >> 30)) * UINT64_C(0xbf58476d1ce4e5b9);
+    z = (z ^ (z >> 27)) * UINT64_C(0x94d049bb133111eb);
+
+    return z ^ (z >> 31);
+}
+
+static double ns_per (clock_t c0, unsigned long cnt)
+{
+    return (double) (clock() - c0) * 1e9 / CLOCKS_PER_SEC / (double) cnt;
+}
+
+
+/* the BPSW path of is_prime_u128(), for an odd (n >= 2^16) : */
+
+static int bpsw_u128 (mont_u128 n)
+{
+    mont128 m;
+
+    if (!p128_sp_test(n))
+        return (0);
+
+    mont128_init(& m, n);
+
+    return p128_is_prime_m(& m);
+}
+
+/******************************************************************************/
+
+int main (void)
+{
+    static const unsigned int bits[] = {64, 96, 128, 0};
+
+    mont_u128 *in = malloc(NVAL * sizeof(mont_u128));
+    uint8_t *ref = malloc(NVAL);
+    uint64_t seed = 1;
+    unsigned int bi, set, reps = 4, r, i;
+
+    if (in == NULL || ref == NULL)
+        return (1);
+
+    fprintf(stdout, "bits : set    : prime64 (ns)  bpsw (ns)  primes\n");
+
+    for (bi = 0; bits[bi] != 0; bi++)
+    for (set = 0; set < 2; set++)
+    {
+        unsigned int k = bits[bi], np = 0;
+        double t_64 = 0.0, t_bp;
+        clock_t c0;
+
+        for (i = 0; i < NVAL; i++)
+        {
+            mont_u128 n = ((mont_u128) rng_next(& seed) << 64) |
+                rng_next(& seed);
+
+            n = (n >> (128 - k)) | ((mont_u128) 1 << (k - 1)) | 0x1;
+
+            if (set != 0) /* the next prime: */
+                while (!bpsw_u128(n)) n += 2;
+
+            in[i] = n;
+        }
+
+        if (k == 64) /* (reference) */
+        {
+            for (c0 = clock(), r = 0; r < reps; r++)
+                for (i = 0; i < NVAL; i++)
+                    ref[i] = (uint8_t) is_prime_u64((uint64_t) in[i]);
+            t_64 = ns_per(c0, (unsigned long) reps * NVAL);
+        }
+
+        for (c0 = clock(), r = 0; r < reps; r++)
+            for (i = 0; i < NVAL; i++)
+                np += (unsigned int) bpsw_u128(in[i]);
+        t_bp = ns_per(c0, (unsigned long) reps * NVAL);
+
+        np /= reps;
+
+        for (i = 0; k == 64 && i < NVAL; i++)
+        {
+            if (bpsw_u128(in[i]) != ref[i])
+            {
+                fprintf(stderr, "p128bench: mismatch: %"PRIu64"\n",
+                        (uint64_t) in[i]);
+                return (1);
+            }
+        }
+
+        if (k == 64)
+            fprintf(stdout, "%4u : %s : %12.1f  %9.1f  %6u\n", k,
+                    (set == 0) ? "random" : "primes", t_64, t_bp, np);
+        else
+            fprintf(stdout, "%4u : %s : %12s  %9.1f  %6u\n", k,
+                    (set == 0) ? "random" : "primes", "-", t_bp, np);
+    }
+
+    free(ref), free(in);
+
+    return (0);
+}
+
+/******************************************************************************/
@@ -0,0 +1,125 @@
+/******************************************************************************/
+
+/* p64bench : scalar vs. batch throughput of the prime64.h interface. */
+
+/* requires '__int128' extended type. */
+
+/* Copyright (c) 2020 Brett Hale.
+ * distributed under BSD-2-Clause license terms. see: mrtab.c */
+
+/******************************************************************************/
+
+/* two input sets of (NVAL) values: random odd 64-bit values, which are
+ * mostly rejected by the first (base-2) round; and 64-bit primes, which
+ * require every round. the random set begins with: 0, 1, 2, to check the
+ * trivial cases. the batch results must match the scalar results.
+ * the two paths are timed alternately, (NTRIAL) times, and the median,
+ * and the range, are reported: the difference between the paths is of
+ * the order of the run-to-run variation on a loaded machine. */
+
+/******************************************************************************/
+
+#include <inttypes.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+
+#include "prime64.h"
+
+#define NVAL (1 << 16)
+#define NTRIAL (7)
+
+
+static uint64_t rng_next (uint64_t *x) /* (splitmix64) */
+{
+    uint64_t z = (*x += UINT64_C(0x9e3779b97f4a7c15));
+
+    z = (z ^ (z >> 30)) * UINT64_C(0xbf58476d1ce4e5b9);
+    z = (z ^ (z >> 27)) * UINT64_C(0x94d049bb133111eb);
+
+    return z ^ (z >> 31);
+}
+
+static double ns_per (clock_t c0, unsigned long cnt)
+{
+    return (double) (clock() - c0) * 1e9 / CLOCKS_PER_SEC / (double) cnt;
+}
+
+static int cmp_dbl (const void *a, const void *b)
+{
+    double x = *(const double *) a, y = *(const double *) b;
+    return (x > y) - (x < y);
+}
+
+/******************************************************************************/
+
+int main (void)
+{
+    uint64_t seed = 1, *in = malloc(NVAL * sizeof(uint64_t));
+    uint8_t *out = malloc(NVAL), *ref = malloc(NVAL);
+    unsigned int set, reps = 4, r, i, j;
+
+    if (in == NULL || out == NULL || ref == NULL)
+        return (1);
+
+    fprintf(stdout, "set    : scalar (ns) [min, max]     "
+            "batch (ns) [min, max]      primes\n");
+
+    for (set = 0; set < 2; set++)
+    {
+        double t_sc[NTRIAL], t_bt[NTRIAL];
+        unsigned int np = 0;
+        clock_t c0;
+
+        for (i = 0; i < NVAL; i++)
+        {
+            uint64_t n = rng_next(& seed) | 0x1;
+
+            if (set != 0) /* the next prime: */
+                while (!is_prime_u64(n)) n += 2;
+
+            in[i] = n;
+        }
+
+        if (set == 0) /* (the values: 0, 1, 2, are resolved directly) */
+            in[0] = 0, in[1] = 1, in[2] = 2;
+
+        for (j = 0; j < NTRIAL; j++)
+        {
+            for (c0 = clock(), r = 0; r < reps; r++)
+                for (i = 0; i < NVAL; i++)
+                    ref[i] = (uint8_t) is_prime_u64(in[i]);
+            t_sc[j] = ns_per(c0, (unsigned long) reps * NVAL);
+
+            for (c0 = clock(), r = 0; r < reps; r++)
+                is_prime_u64_batch(in, out, NVAL);
+            t_bt[j] = ns_per(c0, (unsigned long) reps * NVAL);
+        }
+
+        qsort(t_sc, NTRIAL, sizeof(double), cmp_dbl);
+        qsort(t_bt, NTRIAL, sizeof(double), cmp_dbl);
+
+        for (i = 0; i < NVAL; i++)
+        {
+            if (out[i] != ref[i])
+            {
+                fprintf(stderr, "p64bench: batch mismatch: %"PRIu64"\n",
+                        in[i]);
+                return (1);
+            }
+
+            np += ref[i];
+        }
+
+        fprintf(stdout, "%s : %7.1f [%7.1f, %7.1f]  %7.1f [%7.1f, %7.1f]"
+                "  %6u\n", (set == 0) ? "random" : "primes",
+                t_sc[NTRIAL / 2], t_sc[0], t_sc[NTRIAL - 1],
+                t_bt[NTRIAL / 2], t_bt[0], t_bt[NTRIAL - 1], np);
+    }
+
+    free(ref), free(out), free(in);
+
+    return (0);
+}
+
+/******************************************************************************/
@@ -0,0 +1,140 @@
+/******************************************************************************/
+
+/* prime128 : BPSW primality test for a 128-bit value. */
+
+/* requires '__int128' extended type. */
+
+/* Copyright (c) 2020 Brett Hale.
+ * distributed under BSD-2-Clause license terms. see: mrtab.c */
+
+/******************************************************************************/
+
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+#include "prime128.h" /* is_prime_u128() */
+
+#define U128_MAX (~ (mont_u128) 0)
+
+
+/* return (1) if the nul-terminated C string forms a valid
+ * 128-bit unsigned integer value in C locale decimal format,
+ * and store the value in (u); return (0) otherwise: */
+
+static int u128_arg (mont_u128 *u, const char *s)
+{
+    int ret;
+
+    if ((ret = *s) != 0)
+    {
+        mont_u128 x = 0, d;
+
+        if (ret == '0') /* "0" or not a decimal format: */
+            return (s[1] ? (0) : (*u = x) == 0);
+
+        for (; (d = (mont_u128) (*s++)) != 0; x += d)
+        {
+            if ((d -= ('0')) > (9) ||
+                (x > (U128_MAX / (10)))) return (0);
+            if ((x *= (10)) > (U128_MAX - d))
+                return (0);
+        }
+
+        *u = x; /* a valid 128-bit unsigned integer value. */
+    }
+
+    return ret;
+}
+
+/* write the decimal digits of (u) to (buf), which must have space for
+ * (40) characters, and return (buf) : */
+
+static char *u128_str (char *buf, mont_u128 u)
+{
+    char *s = buf + 39;
+
+    for (*s = '\0'; s == buf + 39 || u != 0; u /= 10)
+        *--s = (char) ('0' + (unsigned int) (u % 10));
+
+    return memmove(buf, s, (size_t) (buf + 40 - s));
+}
+
+/******************************************************************************/
+
+/* the least prime > a, or the greatest prime < a, if (dir < 0). return
+ * (0) if there is no such 128-bit prime: */
+
+static mont_u128 near_prime (mont_u128 a, int dir)
+{
+    mont_u128 x;
+
+    if (dir > 0)
+    {
+        if (a < 2)
+            return (2);
+
+        for (x = (a + 1) | 0x1; x > a; x += 2)
+            if (is_prime_u128(x)) return x;
+    }
+    else
+    {
+        if (a <= 3)
+            return (a == 3) ? (2) : (0);
+
+        for (x = (a - 2) | 0x1; ; x -= 2)
+            if (is_prime_u128(x)) return x;
+    }
+
+    return (0); /* no such prime. */
+}
+
+/******************************************************************************/
+
+static const char *usage =
+    "usage: prime128 < u128 = 2 .. 2^128 - 1 >\n"
+    "       prime128 -n | -p < u128 >\n"
+    "(-n) next prime > u128, (-p) previous prime < u128\n";
+
+int main (int argc, char **argv)
+{
+    mont_u128 n = 0;
+    char buf[40];
+    int argi = 1;
+
+    if (argc > argi && argv[argi][0] == '-') /* search operation: */
+    {
+        const char *op = argv[argi++];
+
+        if (strlen(op) != 2 || strchr("np", op[1]) == NULL ||
+            argc <= argi || !u128_arg(& n, argv[argi]))
+        {
+            fprintf(stderr, "%s", usage);
+            return (1);
+        }
+
+        if ((n = near_prime(n, (op[1] == 'n') ? 1 : -1)) == 0)
+        {
+            fprintf(stderr, "prime128: no such prime\n");
+            return (1);
+        }
+
+        fprintf(stdout, "%s\n", u128_str(buf, n));
+
+        return (0);
+    }
+
+    if (argc <= argi || !u128_arg(& n, argv[argi]) || (n < 2))
+    {
+        fprintf(stderr, "%s", usage);
+        return (1);
+    }
+
+    fprintf(stdout, "%s : %s\n", u128_str(buf, n),
+            is_prime_u128(n) ? "prime" : "composite");
+
+    return (0);
+}
+
+/******************************************************************************/
@@ -0,0 +1,208 @@
+/******************************************************************************/
+
+/* prime128.h : header-only primality test for 128-bit values:
+
+ * int is_prime_u128 (mont_u128 n);
+
+ * requires '__int128' extended type. */
+
+/* Copyright (c) 2020 Brett Hale.
+ * distributed under BSD-2-Clause license terms. see: mrtab.c */
+
+/******************************************************************************/
+
+/* for (n < 2^64), the test is is_prime_u64(), which is deterministic. no
+ * small set of M-R bases is known to be deterministic beyond (2^64), so
+ * for (n >= 2^64) the test is Baillie-PSW: trial division by the primes
+ * in p64_sp_lut, a base-2 SPRP test, and a strong Lucas test with the
+ * Selfridge parameters: the first D in {5, -7, 9, -11, ..} s.t. the
+ * Jacobi symbol (D / n) = -1, with (P = 1, Q = (1 - D) / 4). there is no
+ * known BPSW pseudoprime; the test is deterministic for (n < 2^64). */
+
+/* the Lucas sequences are evaluated left-to-right over the bits of:
+ * d = (n + 1) / 2^s, in the Montgomery domain, with: U(2k) = U(k)V(k),
+ * V(2k) = V(k)^2 - 2Q^k, and: U(k + 1) = (U(k) + V(k)) / 2, V(k + 1) =
+ * (D U(k) + V(k)) / 2. then (n) is a strong Lucas probable prime if:
+ * U(d) = 0, or: V(d 2^r) = 0, for some (0 <= r < s). */
+
+/******************************************************************************/
+
+#ifndef PRIME128_H_
+#define PRIME128_H_
+
+#include <stdint.h>
+
+#include <math.h>
+
+#include "prime64.h" /* is_prime_u64(), p64_sp_lut */
+#include "mont128.h"
+
+
+/* return (0) if (n >= 2^64) has an odd prime factor in p64_sp_lut. the
+ * primes are taken in groups with a product (m < 2^32), so the residue:
+ * n (mod m) is formed from the 64-bit limbs without overflow: */
+
+static inline int p128_sp_test (mont_u128 n)
+{
+    uint64_t lo = (uint64_t) n, hi = (uint64_t) (n >> 64);
+    unsigned int i = 1, j;
+
+    while (p64_sp_lut[i] != 0)
+    {
+        uint64_t m = 1, r;
+
+        for (j = i; p64_sp_lut[j] != 0 && m * p64_sp_lut[j] <= UINT32_MAX; )
+            m *= p64_sp_lut[j++];
+
+        r = (UINT64_MAX % m + 1) % m; /* 2^64 (mod m) */
+        r = ((hi % m) * r + lo % m) % m;
+
+        for (; i < j; i++)
+            if (r % p64_sp_lut[i] == 0) return (0);
+    }
+
+    return (1);
+}
+
+
+/* return (1) if (n) is a perfect square: */
+
+static inline int p128_is_square (mont_u128 n)
+{
+    mont_u128 r = (mont_u128) sqrt((double) n);
+
+    if (r != 0) /* (Newton step: r >= floor(sqrt(n))) */
+        r = (r + n / r) >> 1;
+
+    if (r > UINT64_MAX)
+        r = UINT64_MAX;
+
+    while (r * r > n) r--;
+
+    return (r * r == n);
+}
+
+
+/* the Jacobi symbol (a / n), for an odd (n) : */
+
+static inline int p128_jacobi (mont_u128 a, mont_u128 n)
+{
+    int j = 1;
+
+    for (a %= n; a != 0; a %= n)
+    {
+        mont_u128 t;
+
+        for (; (a & 0x1) == 0; a >>= 1)
+            if ((n & 0x7) == 3 || (n & 0x7) == 5) j = -j;
+
+        t = a, a = n, n = t; /* (quadratic reciprocity) */
+
+        if ((a & 0x3) == 3 && (n & 0x3) == 3)
+            j = -j;
+    }
+
+    return (n == 1) ? j : 0;
+}
+
+/******************************************************************************/
+
+/* strong Lucas probable prime test for an odd (n), with no factor in
+ * p64_sp_lut, given the Montgomery context for (n) : */
+
+static inline int p128_slprp (const mont128 *m)
+{
+    mont_u128 n = m->n, d = n + 1, u, v, qk, qm, dm, dq;
+    long sd = 5;
+    unsigned int s = 0, i;
+    int js;
+
+    /* Selfridge: D in {5, -7, 9, -11, ..} s.t. (D / n) = -1 : */
+
+    for (;; sd = (sd > 0) ? (- sd - 2) : (- sd + 2))
+    {
+        dq = (sd > 0) ? (mont_u128) sd : n - (mont_u128) (- sd);
+
+        if ((js = p128_jacobi(dq, n)) == -1)
+            break;
+
+        if (js == 0) /* (n > |D|) : gcd(D, n) > 1 */
+            return (0);
+
+        if (sd == 13 && p128_is_square(n)) /* (no such D) */
+            return (0);
+    }
+
+    dm = mont128_to(m, dq); /* D R (mod n) */
+
+    qm = (sd > 0) ? n - (mont_u128) (sd - 1) / 4 :
+        (mont_u128) (1 - sd) / 4; /* Q = (1 - D) / 4 (mod n) */
+    qm = mont128_to(m, qm);
+
+    while ((d & 0x1) == 0) d >>= 1, s++;
+    /* d, s s.t. 2^s * d = n + 1, d in odd. */
+
+    for (i = 127; (d >> i) == 0; i--);
+
+    u = m->r1, v = m->r1, qk = qm; /* U(1) = 1, V(1) = P, Q^1 */
+
+    while (i-- != 0)
+    {
+        u = mont128_mul(m, u, v); /* U(2k), V(2k), Q^2k : */
+        v = mont128_sub(m, mont128_mul(m, v, v), mont128_add(m, qk, qk));
+        qk = mont128_mul(m, qk, qk);
+
+        if (((d >> i) & 0x1) != 0) /* U(k + 1), V(k + 1), Q^(k + 1) : */
+        {
+            mont_u128 ut = u;
+
+            u = mont128_half(m, mont128_add(m, u, v));
+            v = mont128_half(m, mont128_add(m, mont128_mul(m, dm, ut), v));
+            qk = mont128_mul(m, qk, qm);
+        }
+    }
+
+    if (u == 0 || v == 0)
+        return (1);
+
+    for (i = 1; i < s; i++) /* V(d 2^r) : */
+    {
+        v = mont128_sub(m, mont128_mul(m, v, v), mont128_add(m, qk, qk));
+
+        if (v == 0)
+            return (1);
+
+        qk = mont128_mul(m, qk, qk);
+    }
+
+    return (0);
+}
+
+
+/* BPSW test for an odd (n), with no factor in p64_sp_lut, given the
+ * Montgomery context for (n). the trial division is left to the caller: */
+
+static inline int p128_is_prime_m (const mont128 *m)
+{
+    return mont128_sprp(m, 2) && p128_slprp(m);
+}
+
+
+static inline int is_prime_u128 (mont_u128 n)
+{
+    mont128 m;
+
+    if ((n >> 64) == 0) /* deterministic test for n < (2^64) : */
+        return is_prime_u64((uint64_t) n);
+
+    if ((n & 0x1) == 0 || !p128_sp_test(n))
+        return (0);
+
+    mont128_init(& m, n);
+
+    return p128_is_prime_m(& m);
+}
+
+/******************************************************************************/
+
+#endif /* PRIME128_H_ */
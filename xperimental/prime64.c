@@ -10,8 +10,17 @@
 /******************************************************************************/
 
 #include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
 #include <stdio.h>
 
+#if defined (_OPENMP)
+#include <omp.h>
+#endif
+
+#include "prime64.h" /* is_prime_u64() */
+#include "factor64.h" /* f64_factor() */
+
 
 /* return (1) if the nul-terminated C string forms a valid
  * 64-bit unsigned integer value in C locale decimal format,
@@ -44,124 +53,346 @@ static int u64_arg (uint64_t *u, const char *s)
 
 /******************************************************************************/
 
-/* 54 primes < 2^8 factor 79.93% of all odd integers: */
+/* an optional database of the base-2 strong pseudoprimes < (2^k), as
+ * generated by the spsp2 utility. for (n < 2^k), a single 2-SPRP test
+ * and a binary search is a deterministic test: */
+
+static uint64_t *spsp_db, spsp_max; /* spsp_max = (2^k) or (0) */
+static size_t spsp_cnt;
+
 
-static const uint8_t sp_lut[] =
+static int spsp_load (const char *path)
 {
-    0x02, 0x03, 0x05, 0x07, 0x0b, 0x0d, 0x11, 0x13,
-    0x17, 0x1d, 0x1f, 0x25, 0x29, 0x2b, 0x2f, 0x35,
-    0x3b, 0x3d, 0x43, 0x47, 0x49, 0x4f, 0x53, 0x59,
-    0x61, 0x65, 0x67, 0x6b, 0x6d, 0x71, 0x7f, 0x83,
-    0x89, 0x8b, 0x95, 0x97, 0x9d, 0xa3, 0xa7, 0xad,
-    0xb3, 0xb5, 0xbf, 0xc1, 0xc5, 0xc7, 0xd3, 0xdf,
-    0xe3, 0xe5, 0xe9, 0xef, 0xf1, 0xfb, 0x00
-};
+    FILE *f = fopen(path, "rb");
+    size_t nc = 0;
+    int c, k;
+
+    if (f == NULL)
+        return (0);
+
+    if ((k = fgetc(f)) < 12 || k > 40) /* (k) byte: */
+    {
+        fclose(f);
+        return (0);
+    }
 
+    for (;;) /* 5-byte little-endian records: */
+    {
+        uint64_t x = 0;
+        unsigned int b;
+
+        for (b = 0; b < 5 && (c = fgetc(f)) != EOF; b++)
+            x |= (uint64_t) c << (8 * b);
+
+        if (b != 5)
+        {
+            fclose(f);
+            return (b == 0);
+        }
+
+        if (spsp_cnt == nc) /* grow the table: */
+        {
+            uint64_t *db;
 
-static int sp_test (uint16_t n)
+            nc = (nc != 0) ? (nc * 2) : (1024);
+            if ((db = realloc(spsp_db, nc * sizeof(uint64_t))) == NULL)
+                return (fclose(f), 0);
+
+            spsp_db = db;
+        }
+
+        spsp_db[spsp_cnt++] = x, spsp_max = (UINT64_C(1) << k);
+    }
+}
+
+
+static int spsp_find (uint64_t n)
 {
-    uint16_t sp = sp_lut[0], q;
+    size_t lo = 0, hi = spsp_cnt;
+
+    while (lo < hi)
+    {
+        size_t i = lo + (hi - lo) / 2;
+
+        if (spsp_db[i] < n)
+            lo = i + 1;
+        else
+            hi = i;
+    }
+
+    return (lo < spsp_cnt && spsp_db[lo] == n);
+}
+
+/******************************************************************************/
 
+static int is_prime (uint64_t n)
+{
     /* assert(n > 1); */
 
-    for (unsigned int i = 1; (q = n / sp) >= sp; )
+    if (n < spsp_max && n >= 65536 && (n & 0x1) != 0)
     {
-        if (q * sp == n) /* composite: */
-            return (0);
+        mont64 m; /* 2-SPRP database: */
 
-        else if ((sp = sp_lut[i++]) == 0) /* EOT entry: */
-            break;
+        mont64_init(& m, n);
+        return mont64_sprp(& m, 2) && !spsp_find(n);
     }
 
-    return (1);
+    return is_prime_u64(n);
 }
 
+
 /******************************************************************************/
 
-static int sprp (uint64_t n, uint64_t a)
+/* range operations: a segmented sieve over the odd values in a window,
+ * using the odd primes < 2^16 (generated from sp_lut) as base primes.
+ * an unmarked value in a window with (hi < 2^32) is prime; otherwise,
+ * only the unmarked values require the M-R test. */
+
+#define SEG_ODDS (UINT32_C(1) << 16) /* odd values per segment. */
+
+static uint16_t bp_lut[6542]; /* odd primes < 2^16, EOT entry. */
+
+
+static void bp_init (void)
 {
-    uint64_t m = n - 1, r, y;
-    unsigned int s = 1, j;
+    unsigned int i = 0;
+
+    for (uint32_t n = 3; n < 65536; n += 2)
+        if (p64_sp_test((uint16_t) n)) bp_lut[i++] = (uint16_t) n;
 
-    /* assert(n > 2 && (n & 0x1) != 0); */
-    /* note: modified M-R test for successive bases. */
+    bp_lut[i] = 0; /* EOT entry (6541 odd primes) */
+}
 
-    while ((m & (UINT64_C(1) << s)) == 0) s++;
-    r = m >> s; /* r, s s.t. 2^s * r = n - 1, r in odd. */
 
-    if ((a %= n) == 0) /* else (0 < a < n) */
-        return (1);
+/* sieve the odd values: {lo .. hi}, where (lo) is odd, (hi >= lo), and
+ * there are at most (SEG_ODDS) values. store the primes in (pbuf), and
+ * return the number of primes found: */
+
+static size_t seg_primes (uint64_t *pbuf, uint64_t lo, uint64_t hi)
+{
+    uint8_t f[SEG_ODDS];
+    uint64_t nf = (hi - lo) / 2 + 1, i;
+    size_t np = 0;
+
+    memset(f, 0, nf);
 
+    for (const uint16_t *bp = bp_lut; *bp != 0; bp++)
     {
-        __extension__ unsigned __int128 u = 1, w = a;
+        uint64_t p = *bp, x;
 
-        while (r != 0)
-        {
-            if ((r & 0x1) != 0)
-                u = (u * w) % n; /* (mul-rdx) */
+        if (p * p > hi)
+            break;
 
-            if ((r >>= 1) != 0)
-                w = (w * w) % n; /* (sqr-rdx) */
-        }
+        if ((x = p * p) < lo) /* first odd multiple >= lo : */
+            if (((x = lo + (p - lo % p) % p) & 0x1) == 0) x += p;
 
-        if ((y = (uint64_t) u) == 1)
-            return (1);
+        for (i = (x - lo) / 2; i < nf; i += p) f[i] = 1;
     }
 
-    for (j = 1; j < s && y != m; j++)
+    for (i = 0; i < nf; i++)
     {
-        __extension__ unsigned __int128 u = y;
-        u = (u * u) % n; /* (sqr-rdx) */
+        uint64_t x = lo + 2 * i;
 
-        if ((y = (uint64_t) u) <= 1) /* (n) is composite: */
-            return (0);
+        if (f[i] == 0 && x > 1 && (hi <= UINT32_MAX || is_prime(x)))
+            pbuf[np++] = x;
     }
 
-    return (y == m);
+    return np;
 }
 
-/******************************************************************************/
 
-static int is_prime (uint64_t n)
+/* count, or list (to stdout), the primes in: [a, b]. the segments are
+ * distributed across threads if built with OpenMP support: */
+
+static uint64_t range_primes (uint64_t a, uint64_t b, int list)
 {
-    const uint32_t sprp32_base[] = /* (Jaeschke) */ {
-        2, 7, 61, 0};
+    uint64_t lo, nseg, seg, cnt = 0;
 
-    const uint32_t sprp64_base[] = /* (Sinclair) */ {
-        2, 325, 9375, 28178, 450775, 9780504, 1795265022, 0};
+    if (a <= 2 && b >= 2)
+    {
+        if (list) fprintf(stdout, "2\n");
+        cnt++;
+    }
 
-    const uint32_t *sprp_base;
+    if ((lo = (a < 3) ? 3 : (a | 0x1)) > b || lo < a)
+        return cnt;
 
-    /* assert(n > 1); */
+    nseg = ((b - lo) / 2) / SEG_ODDS + 1;
+
+#if defined (_OPENMP)
+#pragma omp parallel for ordered schedule(dynamic) reduction(+:cnt)
+#endif
+    for (seg = 0; seg < nseg; seg++)
+    {
+        uint64_t *pbuf = malloc(SEG_ODDS * sizeof(uint64_t)), x0, x1;
+        size_t np;
+
+        if (pbuf == NULL)
+            abort();
+
+        x0 = lo + seg * SEG_ODDS * 2;
+        x1 = ((b - x0) / 2 < SEG_ODDS) ? b : x0 + (SEG_ODDS - 1) * 2;
 
-    if ((n & 0x1) == 0) /* even: */
-        return (n == 2);
+        cnt += (np = seg_primes(pbuf, x0, x1));
 
-    if (n < 65536) /* trial division for n < (2^16) : */
-        return sp_test((uint16_t) n);
+#if defined (_OPENMP)
+#pragma omp ordered
+#endif
+        if (list)
+            for (size_t i = 0; i < np; i++)
+                fprintf(stdout, "%"PRIu64"\n", pbuf[i]);
+
+        free(pbuf);
+    }
+
+    return cnt;
+}
 
-    sprp_base = (n <= UINT32_MAX) ? sprp32_base : sprp64_base;
 
-    for (; *sprp_base != 0; sprp_base++)
-        if (!sprp(n, *sprp_base)) return (0);
+/* the least prime > a, or the greatest prime < a, if (dir < 0). return
+ * (0) if there is no such 64-bit prime: */
+
+static uint64_t near_prime (uint64_t a, int dir)
+{
+    uint64_t pbuf[SEG_ODDS / 16], x0, x1;
+    const uint64_t w = (SEG_ODDS / 16 - 1) * 2; /* window span. */
+
+    if (dir > 0)
+    {
+        if (a < 2)
+            return (2);
+
+        for (x0 = (a + 1) | 0x1; x0 > a; x0 = x1 + 2)
+        {
+            size_t np;
+
+            x1 = (UINT64_MAX - x0 < w) ? UINT64_MAX : x0 + w;
+            if ((np = seg_primes(pbuf, x0, x1)) != 0)
+                return pbuf[0];
+
+            if (x1 == UINT64_MAX) break;
+        }
+    }
+    else
+    {
+        if (a <= 3)
+            return (a == 3) ? (2) : (0);
 
-    return (1);
+        for (x1 = (a - 2) | 0x1; x1 >= 3; x1 = x0 - 2)
+        {
+            size_t np;
+
+            x0 = (x1 - 3 < w) ? 3 : x1 - w;
+            if ((np = seg_primes(pbuf, x0, x1)) != 0)
+                return pbuf[np - 1];
+
+            if (x0 == 3) return (2);
+        }
+    }
+
+    return (0); /* no such prime. */
 }
 
+/******************************************************************************/
+
+static const char *usage =
+    "usage: prime64 [-s <spsp2 file>] < u64 = 2 .. 2^64 - 1 >\n"
+    "       prime64 [-s <spsp2 file>] -n | -p | -f < u64 >\n"
+    "       prime64 [-s <spsp2 file>] -c | -l < u64 a > < u64 b >\n"
+    "(-n) next prime > u64, (-p) previous prime < u64,\n"
+    "(-f) prime factorization of u64 (> 1),\n"
+    "(-c) count, (-l) list the primes in [a, b]\n";
 
 int main (int argc, char **argv)
 {
-    uint64_t n = 0;
+    uint64_t n = 0, b = 0;
+    const char *op = NULL;
+    int argi = 1;
+
+    SPRP_STAT_INIT();
+
+    if (argc > 3 && strcmp(argv[1], "-s") == 0)
+    {
+        if (!spsp_load(argv[2]))
+        {
+            fprintf(stderr, "prime64: invalid spsp2 file: %s\n", argv[2]);
+            return (1);
+        }
 
-    if (argc < 2 || !u64_arg(& n, argv[1]) || (n < 2))
+        argi += 2;
+    }
+
+    if (argc > argi && argv[argi][0] == '-') /* range operation: */
     {
-        fprintf(stderr, "usage: prime64 < u64 = 2 .. 2^64 - 1 >\n");
+        op = argv[argi++];
+
+        if (strlen(op) != 2 || strchr("npclf", op[1]) == NULL ||
+            argc <= argi || !u64_arg(& n, argv[argi]) ||
+            (strchr("cl", op[1]) != NULL &&
+             (argc <= argi + 1 || !u64_arg(& b, argv[argi + 1]))))
+        {
+            fprintf(stderr, "%s", usage);
+            return (1);
+        }
+
+        bp_init();
+
+        switch (op[1])
+        {
+        case 'c':
+            fprintf(stdout, "%"PRIu64"\n", range_primes(n, b, 0));
+            break;
+
+        case 'l':
+            range_primes(n, b, 1);
+            break;
+
+        case 'f':
+        {
+            uint64_t pbuf[F64_MAX];
+            unsigned int pn, i;
+
+            if (n < 2)
+            {
+                fprintf(stderr, "%s", usage);
+                return (1);
+            }
+
+            fprintf(stdout, "%"PRIu64" =", n);
+            for (pn = f64_factor(pbuf, n), i = 0; i < pn; i++)
+                fprintf(stdout, "%s %"PRIu64, (i) ? " *" : "", pbuf[i]);
+            fprintf(stdout, "\n");
+
+            break;
+        }
+
+        default: /* (-n, -p) : */
+            if ((n = near_prime(n, (op[1] == 'n') ? 1 : -1)) == 0)
+            {
+                fprintf(stderr, "prime64: no such prime\n");
+                return (1);
+            }
+
+            fprintf(stdout, "%"PRIu64"\n", n);
+            break;
+        }
+
+        SPRP_STAT_REPORT();
+
+        return (0);
+    }
+
+    if (argc <= argi || !u64_arg(& n, argv[argi]) || (n < 2))
+    {
+        fprintf(stderr, "%s", usage);
         return (1);
     }
 
     fprintf(stdout, "%"PRIu64" : %s\n", n,
             is_prime(n) ? "prime" : "composite");
 
+    SPRP_STAT_REPORT();
+
     return (0);
 }
 
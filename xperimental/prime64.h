@@ -0,0 +1,326 @@
+/******************************************************************************/
+
+/* prime64.h : header-only deterministic primality test for 64-bit values,
+ * with a scalar and a batched (array) interface:
+
+ * int is_prime_u64 (uint64_t n);
+ * void is_prime_u64_batch (const uint64_t *in, uint8_t *out, size_t cnt);
+
+ * requires '__int128' extended type. */
+
+/* Copyright (c) 2020 Brett Hale.
+ * distributed under BSD-2-Clause license terms. see: mrtab.c */
+
+/******************************************************************************/
+
+/* the batch interface interleaves the M-R exponentiation of (P64_LANES)
+ * independent candidates, so the latency of each Montgomery multiply is
+ * hidden by the others. (a 64 x 64 -> 128-bit multiply has no general
+ * SIMD form, so there is no vector path.)
+
+ * the scalar interface tests base-2 first, which rejects almost every
+ * composite. for a value that passes - a prime, or a strong liar - the
+ * remaining bases are independent exponentiations of the same (n), and
+ * are interleaved in groups of up to (P64_LANES). */
+
+/******************************************************************************/
+
+#ifndef PRIME64_H_
+#define PRIME64_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "mont64.h"
+
+#define P64_LANES (4)
+
+
+/* 54 primes < 2^8 factor 79.93% of all odd integers: */
+
+static const uint8_t p64_sp_lut[] =
+{
+    0x02, 0x03, 0x05, 0x07, 0x0b, 0x0d, 0x11, 0x13,
+    0x17, 0x1d, 0x1f, 0x25, 0x29, 0x2b, 0x2f, 0x35,
+    0x3b, 0x3d, 0x43, 0x47, 0x49, 0x4f, 0x53, 0x59,
+    0x61, 0x65, 0x67, 0x6b, 0x6d, 0x71, 0x7f, 0x83,
+    0x89, 0x8b, 0x95, 0x97, 0x9d, 0xa3, 0xa7, 0xad,
+    0xb3, 0xb5, 0xbf, 0xc1, 0xc5, 0xc7, 0xd3, 0xdf,
+    0xe3, 0xe5, 0xe9, 0xef, 0xf1, 0xfb, 0x00
+};
+
+static const uint32_t p64_sprp32_base[] = /* (Jaeschke) */ {
+    2, 7, 61, 0};
+
+static const uint32_t p64_sprp64_base[] = /* (Sinclair) */ {
+    2, 325, 9375, 28178, 450775, 9780504, 1795265022, 0};
+
+/******************************************************************************/
+
+static inline int p64_sp_test (uint16_t n)
+{
+    uint16_t sp = p64_sp_lut[0], q;
+
+    /* assert(n > 1); */
+
+    for (unsigned int i = 1; (q = n / sp) >= sp; )
+    {
+        if (q * sp == n) /* composite: */
+            return (0);
+
+        else if ((sp = p64_sp_lut[i++]) == 0) /* EOT entry: */
+            break;
+    }
+
+    return (1);
+}
+
+
+/* a-SPRP tests of an odd (n > 3) for (cnt <= P64_LANES) bases, with a
+ * shared exponent. return (1) only if (n) is an a-SPRP for every base. a
+ * base (a = 0 mod n) is a pass, as with mont64_sprp(). with '-DSPRP_STATS',
+ * each base is recorded as a call to mont64_sprp() would be: */
+
+static inline int p64_sprp_group (const mont64 *m, const uint32_t *base,
+                                  unsigned int cnt)
+{
+    uint64_t u[P64_LANES], w[P64_LANES], r = m->n - 1, y;
+    uint64_t one = m->r1, neg = m->n - m->r1;
+    unsigned int s = 0, l, k, j, res = 0, zm = 0;
+
+    while ((r & 0x1) == 0) r >>= 1, s++;
+    /* r, s s.t. 2^s * r = n - 1, r in odd. */
+
+    SPRP_STAT_ENTER_N(s);
+
+    for (l = 0; l < cnt; l++)
+    {
+        uint64_t a = base[l] % m->n;
+
+        zm |= (a == 0) << l; /* (a pass, not a call) */
+        u[l] = one, w[l] = mont64_to(m, a);
+    }
+
+    for (; r != 0; r >>= 1)
+    {
+        if ((r & 0x1) != 0)
+            for (l = 0; l < cnt; l++) /* (mul-rdx) */
+                u[l] = mont64_mul(m, u[l], w[l]), SPRP_STAT_MUL_N(l);
+
+        if (r != 1)
+            for (l = 0; l < cnt; l++) /* (sqr-rdx) */
+                w[l] = mont64_mul(m, w[l], w[l]), SPRP_STAT_MUL_N(l);
+    }
+
+    for (l = 0; l < cnt; l++)
+    {
+        if ((zm & (1U << l)) != 0)
+            continue;
+
+        if (u[l] == one || u[l] == neg)
+            SPRP_STAT_LEAVE_N(l, (u[l] == one) ? 0 : 1, 0);
+        else
+            res |= 1U << l;
+    }
+
+    for (j = 1; j < s && res != 0; j++)
+    {
+        for (l = 0; l < cnt; l++)
+        {
+            if ((res & (1U << l)) == 0)
+                continue;
+
+            y = u[l] = mont64_mul(m, u[l], u[l]), SPRP_STAT_MUL_N(l);
+
+            if (y == neg)
+            {
+                res ^= (1U << l);
+                SPRP_STAT_LEAVE_N(l, 1, j);
+            }
+            else if (y == one) /* (n) is composite: */
+            {
+                SPRP_STAT_LEAVE_N(l, 2, j);
+
+                for (k = 0; k < cnt; k++) /* (the other lanes) */
+                    if (k != l && (res & (1U << k)) != 0)
+                        SPRP_STAT_LEAVE_N(k, 4, j);
+
+                SPRP_STAT_DONE_N();
+                return (0);
+            }
+        }
+    }
+
+    for (l = 0; l < cnt; l++)
+        if ((res & (1U << l)) != 0)
+            SPRP_STAT_LEAVE_N(l, 3, s - 1);
+
+    SPRP_STAT_DONE_N();
+    return (res == 0);
+}
+
+
+/* deterministic test for an odd (n > 3), given the Montgomery context
+ * for (n). the base-2 test is performed first, then the remaining bases
+ * in groups; a witness in a group stops the test: */
+
+static inline int p64_is_prime_m (const mont64 *m)
+{
+    const uint32_t *sprp_base;
+    unsigned int nb, ng;
+
+    sprp_base = (m->n <= UINT32_MAX) ? p64_sprp32_base : p64_sprp64_base;
+
+    if (!mont64_sprp(m, *sprp_base++))
+        return (0);
+
+    for (nb = 0; sprp_base[nb] != 0; nb++);
+
+    for (; nb != 0; sprp_base += ng, nb -= ng)
+    {
+        ng = (nb + P64_LANES - 1) / P64_LANES; /* (groups) */
+        ng = (nb + ng - 1) / ng; /* (balanced) */
+
+        if (!p64_sprp_group(m, sprp_base, ng)) return (0);
+    }
+
+    return (1);
+}
+
+
+static inline int is_prime_u64 (uint64_t n)
+{
+    mont64 m;
+
+    if (n < 2) /* (0, 1 are not prime) */
+        return (0);
+
+    if ((n & 0x1) == 0) /* even: */
+        return (n == 2);
+
+    if (n < 65536) /* trial division for n < (2^16) : */
+        return p64_sp_test((uint16_t) n);
+
+    mont64_init(& m, n);
+
+    return p64_is_prime_m(& m);
+}
+
+/******************************************************************************/
+
+/* a-SPRP tests for (P64_LANES) odd values, each with its own base (a),
+ * where (a < n). the right-to-left exponentiations are interleaved: */
+
+static inline void p64_sprp_lanes (const mont64 *m, const uint64_t *a,
+                                   uint8_t *res)
+{
+    uint64_t r[P64_LANES], u[P64_LANES], w[P64_LANES], rs;
+    unsigned int s[P64_LANES], l, j;
+
+    for (l = 0; l < P64_LANES; l++)
+    {
+        for (r[l] = m[l].n - 1, s[l] = 0; (r[l] & 0x1) == 0; s[l]++)
+            r[l] >>= 1; /* r, s s.t. 2^s * r = n - 1, r in odd. */
+
+        u[l] = m[l].r1, w[l] = mont64_to(m + l, a[l]);
+    }
+
+    do
+    {
+        for (rs = 0, l = 0; l < P64_LANES; l++)
+        {
+            uint64_t t = mont64_mul(m + l, u[l], w[l]); /* (mul-rdx) */
+
+            u[l] = ((r[l] & 0x1) != 0) ? t : u[l]; /* (no branch) */
+            w[l] = mont64_mul(m + l, w[l], w[l]); /* (sqr-rdx) */
+            rs |= (r[l] >>= 1);
+        }
+    }
+    while (rs != 0);
+
+    for (l = 0; l < P64_LANES; l++)
+    {
+        uint64_t one = m[l].r1, neg = m[l].n - m[l].r1, y = u[l];
+
+        res[l] = (a[l] == 0 || y == one || y == neg);
+
+        for (j = 1; j < s[l] && res[l] == 0; j++)
+        {
+            if ((y = mont64_mul(m + l, y, y)) == neg)
+                res[l] = 1;
+            else if (y == one) /* (n) is composite: */
+                break;
+        }
+    }
+}
+
+
+static inline void is_prime_u64_batch (const uint64_t *in, uint8_t *out,
+                                       size_t cnt)
+{
+    mont64 m[P64_LANES];
+    uint64_t a[P64_LANES];
+    uint8_t res[P64_LANES];
+    size_t idx[P64_LANES], i = 0;
+    unsigned int bi[P64_LANES], nl = 0, l;
+
+    /* each lane holds a candidate until it fails a base, or passes the
+     * last one. a free lane is refilled from the input, so the lanes
+     * stay busy with independent work. trivial values are resolved as
+     * they are read: */
+
+    for (;;)
+    {
+        while (nl < P64_LANES && i < cnt)
+        {
+            uint64_t n = in[i];
+
+            if ((n & 0x1) == 0 || n < 65536)
+            {
+                out[i] = (n < 2) ? 0 : ((n & 0x1) == 0) ? (n == 2) :
+                    (uint8_t) p64_sp_test((uint16_t) n);
+                i++;
+                continue;
+            }
+
+            mont64_init(m + nl, n);
+            idx[nl] = i++, bi[nl++] = 0;
+        }
+
+        if (nl == 0)
+            break;
+
+        for (l = 0; l < P64_LANES; l++) /* (pad with a copy of lane 0) */
+        {
+            if (l >= nl)
+                m[l] = m[0], bi[l] = bi[0], idx[l] = idx[0];
+
+            a[l] = ((m[l].n <= UINT32_MAX) ? p64_sprp32_base :
+                    p64_sprp64_base)[bi[l]] % m[l].n;
+        }
+
+        p64_sprp_lanes(m, a, res);
+
+        for (l = 0; l < nl; )
+        {
+            const uint32_t *sprp_base = (m[l].n <= UINT32_MAX) ?
+                p64_sprp32_base : p64_sprp64_base;
+
+            if (res[l] != 0 && sprp_base[++bi[l]] != 0)
+            {
+                l++; /* (next base) */
+                continue;
+            }
+
+            out[idx[l]] = res[l]; /* retire lane (l) : */
+
+            if (--nl != l)
+                m[l] = m[nl], bi[l] = bi[nl], idx[l] = idx[nl],
+                    res[l] = res[nl];
+        }
+    }
+}
+
+/******************************************************************************/
+
+#endif /* PRIME64_H_ */
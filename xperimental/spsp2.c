@@ -0,0 +1,280 @@
+/******************************************************************************/
+
+/* spsp2 : enumerate the base-2 strong pseudoprimes < (2^k), k <= 40. */
+
+/* requires '__int128' extended type. the search is multi-threaded if
+ * built with OpenMP support, e.g., 'cc -O2 -fopenmp'. */
+
+/* Copyright (c) 2020 Brett Hale.
+ * distributed under BSD-2-Clause license terms. see: mrtab.c */
+
+/******************************************************************************/
+
+/* every composite n < 2^k has a prime factor p < 2^(k/2). if (n) is a
+ * 2-SPRP (or merely a Fermat pseudoprime), then for each prime p | n :
+ * ord_p(2) | (n - 1), and since gcd(p, ord_p(2)) = 1, this is only the
+ * case for n = p * m, where: m = 1 (mod ord_p(2)).
+
+ * a segmented sieve marks every multiple of each odd prime p < 2^(k/2),
+ * and flags those multiples not in the admissible class. an unmarked
+ * value is prime. only a marked value with no flag requires a 2-SPRP
+ * test; there are very few of these. */
+
+/* output: a single byte (k), followed by the 2-SPRP values in ascending
+ * order, as 5-byte little-endian records. this is the database format
+ * used by: 'prime64 -s <file>'. */
+
+/******************************************************************************/
+
+#include <inttypes.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+#if defined (_OPENMP)
+#include <omp.h>
+#endif
+
+#include "../spk12.h" /* small prime factorization. */
+#include "mont64.h"
+
+
+/* return (1) if the nul-terminated C string forms a valid
+ * 32-bit unsigned integer value in C locale decimal format,
+ * and store the value in (u); return (0) otherwise: */
+
+static int u32_arg (unsigned long *u, const char *s)
+{
+    int ret;
+
+    if ((ret = *s) != 0)
+    {
+        unsigned long x = 0, d;
+
+        if (ret == '0') /* "0" or not a decimal format: */
+            return (s[1] ? (0) : (*u = x) == 0);
+
+        for (; (d = (unsigned long) (*s++)) != 0; x += d)
+        {
+            if ((d -= ('0')) > (9) ||
+                (x > (0xffffffffUL / (10)))) return (0);
+            if ((x *= (10)) > (0xffffffffUL - d))
+                return (0);
+        }
+
+        *u = x; /* a valid 32-bit unsigned integer value. */
+    }
+
+    return ret;
+}
+
+/******************************************************************************/
+
+/* ord_p(2) for an odd prime p < 2^24 : */
+
+static uint32_t ord2 (uint32_t p)
+{
+    uint32_t pbuf[(24)], o = p - 1;
+    unsigned int pn = sp_factor(pbuf, p - 1), i;
+
+    for (i = 0; i < pn; i++)
+    {
+        uint32_t q = pbuf[i], e = o / q;
+        uint64_t u = 1, w = 2;
+
+        if (o % q != 0) /* (repeated factor) */
+            continue;
+
+        for (; e != 0; e >>= 1, w = (w * w) % p)
+            if ((e & 0x1) != 0) u = (u * w) % p;
+
+        if (u == 1) o /= q;
+    }
+
+    return o;
+}
+
+
+#define SEG_ODDS (UINT32_C(1) << 20) /* odd values per segment. */
+
+/* sieve the segments {b0 .. b1 - 1} of odd values. the next multiple of
+ * each prime, and its cofactor (m) mod ord_p(2), carry over from one
+ * segment to the next, so they are computed once per thread: */
+
+static uint64_t *spsp_range (uint64_t *cnt, uint64_t b0, uint64_t b1,
+                             uint64_t nmax, const uint32_t *sp,
+                             const uint32_t *so, uint32_t np)
+{
+    uint64_t *nx = malloc(np * sizeof(uint64_t)), *buf = NULL, nb = 0, nc = 0;
+    uint32_t *mr = malloc(np * sizeof(uint32_t)), i;
+    uint8_t *f = malloc(SEG_ODDS);
+
+    if (nx == NULL || mr == NULL || f == NULL)
+        abort();
+
+    for (i = 0; i < np; i++)
+    {
+        uint64_t p = sp[i], lo = b0 * SEG_ODDS * 2 + 1, m;
+
+        if ((m = (lo + p - 1) / p) < 3)
+            m = 3;
+        m |= 0x1; /* odd multiple: */
+        nx[i] = p * m, mr[i] = (uint32_t) (m % so[i]);
+    }
+
+    for (uint64_t b = b0; b < b1; b++)
+    {
+        uint64_t lo = b * SEG_ODDS * 2 + 1, hi = lo + SEG_ODDS * 2, n;
+
+        for (n = 0; n < SEG_ODDS; n++) f[n] = 0;
+
+        for (i = 0; i < np; i++)
+        {
+            uint64_t x = nx[i], d = 2 * (uint64_t) sp[i];
+            uint32_t r = mr[i], o = so[i];
+
+            for (; x < hi; x += d)
+            {
+                f[(x - lo) >> 1] |= (r == 1) ? 1 : 3;
+                if ((r += 2) >= o) r -= o;
+            }
+
+            nx[i] = x, mr[i] = r;
+        }
+
+        for (n = 0; n < SEG_ODDS; n++)
+        {
+            uint64_t x = lo + 2 * n;
+            mont64 m;
+
+            if (f[n] != 1 || x >= nmax)
+                continue;
+
+            mont64_init(& m, x);
+            if (!mont64_sprp(& m, 2))
+                continue;
+
+            if (nb == nc) /* grow the buffer: */
+            {
+                nc = (nc != 0) ? (nc * 2) : (64);
+                if ((buf = realloc(buf, nc * sizeof(uint64_t))) == NULL)
+                    abort();
+            }
+
+            buf[nb++] = x;
+        }
+    }
+
+    free(f), free(mr), free(nx);
+
+    *cnt = nb;
+    return buf;
+}
+
+/******************************************************************************/
+
+int main (int argc, char **argv)
+{
+    uint32_t k = (40), pmax, np, i, *sp, *so;
+    uint64_t nmax, nblk, total = 0;
+    uint8_t *c;
+
+    if (argc > 1) /* (k) option: */
+    {
+        unsigned long u;
+
+        if (!u32_arg(& u, argv[1]) || (u < 12) || (u > 40))
+        {
+            fprintf(stderr, "usage: spsp2 [k] > file, where: "
+                    "k = 12 .. 40 (default: 40)\n");
+            return (1);
+        }
+
+        k = (uint32_t) u;
+    }
+
+    SPRP_STAT_INIT();
+
+    nmax = (UINT64_C(1) << k);
+    pmax = (UINT32_C(1) << ((k + 1) / 2)); /* p < sqrt(nmax) */
+
+    /* odd primes < pmax (sieve of Eratosthenes) : */
+
+    if ((c = calloc(pmax, 1)) == NULL)
+        return (1);
+
+    for (np = 0, i = 3; i < pmax; i += 2)
+    {
+        if (c[i] != 0) /* composite: */
+            continue;
+
+        for (uint64_t j = (uint64_t) i * i; j < pmax; j += 2 * i)
+            c[j] = 1;
+
+        np++;
+    }
+
+    sp = malloc(np * sizeof(uint32_t));
+    so = malloc(np * sizeof(uint32_t));
+
+    if (sp == NULL || so == NULL)
+        return (1);
+
+    for (np = 0, i = 3; i < pmax; i += 2)
+        if (c[i] == 0) sp[np] = i, so[np++] = ord2(i);
+
+    free(c);
+
+    nblk = (nmax / 2 + SEG_ODDS - 1) / SEG_ODDS;
+
+    fputc((int) k, stdout);
+
+#if defined (_OPENMP)
+#pragma omp parallel reduction(+:total)
+#endif
+    {
+        uint64_t b0, b1, cnt, *buf, j;
+        unsigned int tid = 0, nth = 1;
+
+#if defined (_OPENMP)
+        tid = (unsigned int) omp_get_thread_num();
+        nth = (unsigned int) omp_get_num_threads();
+#endif
+
+        b0 = nblk * tid / nth, b1 = nblk * (tid + 1) / nth;
+        buf = spsp_range(& cnt, b0, b1, nmax, sp, so, np);
+
+        /* contiguous ranges are written in thread order. with a
+         * (static, 1) schedule, iteration (ti) is run by thread (ti) : */
+
+#if defined (_OPENMP)
+#pragma omp for ordered schedule(static, 1)
+#endif
+        for (unsigned int ti = 0; ti < nth; ti++)
+        {
+#if defined (_OPENMP)
+#pragma omp ordered
+#endif
+            for (j = 0; j < cnt; j++)
+            {
+                uint64_t x = buf[j];
+
+                for (unsigned int b = 0; b < 5; b++, x >>= 8)
+                    fputc((int) (x & 0xff), stdout);
+            }
+        }
+
+        total += cnt;
+        free(buf);
+    }
+
+    free(so), free(sp);
+
+    fprintf(stderr, "%"PRIu64" 2-SPRP composites < 2^%"PRIu32"\n",
+            total, k);
+
+    SPRP_STAT_REPORT();
+
+    return (0);
+}
+
+/******************************************************************************/
@@ -0,0 +1,189 @@
+/******************************************************************************/
+
+/* tdbench : measured costs for the trial division bound (mrtab -c), and a
+ * random probable prime search to validate the bound for (128 .. 512)-bit
+ * candidates, using the multi-precision kernels (mpmont.h). */
+
+/* requires '__int128' extended type. */
+
+/* Copyright (c) 2020 Brett Hale.
+ * distributed under BSD-2-Clause license terms. see: mrtab.c */
+
+/******************************************************************************/
+
+/* the costs are measured in picoseconds: (cd) per limb and prime, as a
+ * (64 : 64) remainder for each limb; (cm) per bit and limb^2, for the
+ * setup and a single (base-2) M-R round.
+
+ * the search divides each of a fixed set of random odd k-bit candidates
+ * by the first (n) odd primes in sp_lut, and tests the survivors; the
+ * time per prime found is compared to the model of mrtab, for several
+ * (n) around the optimum. the same set is used for each (n), so the
+ * comparison is not subject to the variance of the prime count. only the
+ * first M-R round depends on (n), so (t = 1) here.
+
+ * the optimum is limited to the (563) odd primes < (2^12). from (k ~ 512)
+ * it is at the limit, since: c_exp(k) / c_div(k) > (2^12). */
+
+/******************************************************************************/
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <time.h>
+
+#include <math.h>
+
+#include "mpmont.h"
+#include "../spk12.h" /* small prime LUT. */
+
+#ifndef M_LN2
+#define M_LN2 (0.69314718055994530941723212145817657)
+#endif
+
+#define TD_PRIMES (563) /* odd primes < (2^12) */
+#define NCAND (8192)
+
+
+static uint64_t rng_next (uint64_t *x) /* (splitmix64) */
+{
+    uint64_t z = (*x += UINT64_C(0x9e3779b97f4a7c15));
+
+    z = (z ^ (z >> 30)) * UINT64_C(0xbf58476d1ce4e5b9);
+    z = (z ^ (z >> 27)) * UINT64_C(0x94d049bb133111eb);
+
+    return z ^ (z >> 31);
+}
+
+static void rng_cand (uint64_t *seed, uint64_t *n, unsigned int nl)
+{
+    for (unsigned int i = 0; i < nl; i++)
+        n[i] = rng_next(seed);
+
+    n[0] |= 0x1, n[nl - 1] |= UINT64_C(1) << 63; /* odd, full-width */
+}
+
+/******************************************************************************/
+
+/* return (0) if (n) has a factor in the first (np) odd primes: */
+
+static int td_test (const uint64_t *n, unsigned int nl, unsigned int np)
+{
+    for (unsigned int i = 1; i <= np; i++)
+    {
+        uint64_t p = sp_lut[i], r = 0;
+
+        for (unsigned int j = nl; j-- != 0; )
+            r = (uint64_t) ((((mp_u128) r << 64) | n[j]) % p);
+
+        if (r == 0) /* composite: */
+            return (0);
+    }
+
+    return (1);
+}
+
+/* the model of mrtab's td_opt(), with (1 / rho) : */
+
+static double td_model (unsigned int k, unsigned int np, double cd,
+                        double cm)
+{
+    double nl = (double) (k / 64), sn = 1.0, ct = 0.0;
+
+    for (unsigned int i = 1; i <= np; i++)
+        ct += cd * nl * sn, sn *= 1.0 - 1.0 / sp_lut[i];
+
+    return (ct + sn * cm * k * nl * nl) * (k * M_LN2 / 2.0);
+}
+
+/******************************************************************************/
+
+int main (void)
+{
+    static const unsigned int bits[] = {128, 256, 512, 0};
+    static mpmont m;
+    static volatile unsigned int sink;
+    static uint64_t cand[NCAND][8];
+
+    uint64_t seed = 1;
+    double cd = 0.0, cm[3];
+    unsigned int bi, i, j;
+    clock_t c0;
+
+    for (bi = 0; bits[bi] != 0; bi++) /* measured costs: */
+    {
+        unsigned int k = bits[bi], nl = k / 64, reps;
+        double t;
+
+        for (i = 0; i < 256; i++)
+            rng_cand(& seed, cand[i], nl);
+
+        for (reps = 0, c0 = clock(); reps < 16; reps++)
+            for (i = 0; i < 256; i++) /* (no early exit) */
+                for (j = 1; j <= TD_PRIMES; j++)
+                {
+                    uint64_t p = sp_lut[j], r = 0;
+                    unsigned int l;
+
+                    for (l = nl; l-- != 0; )
+                        r = (uint64_t) ((((mp_u128) r << 64) | cand[i][l])
+                                        % p);
+                    sink += (r == 0);
+                }
+
+        t = (double) (clock() - c0) * 1e12 / CLOCKS_PER_SEC;
+        cd += t / (16.0 * 256 * TD_PRIMES * nl) / 3.0;
+
+        for (reps = 256 / nl, c0 = clock(), i = 0; i < 256 * reps; i++)
+            mp_init(& m, cand[i % 256], nl), sink += mp_sprp(& m, 2, nl);
+
+        t = (double) (clock() - c0) * 1e12 / CLOCKS_PER_SEC;
+        cm[bi] = t / (256.0 * reps * k * nl * nl);
+    }
+
+    fprintf(stdout, "cd = %.0f ps; cm = %.0f ps (128), %.0f ps (256), "
+            "%.0f ps (512)\n", cd, cm[0], cm[1], cm[2]);
+    fprintf(stdout, "usage: mrtab -c %.0f %.0f %.0f %.0f [s]\n\n", cd,
+            cm[0], cm[1], cm[2]);
+
+    fprintf(stdout, " bits :    n : model (us)  search (us)  primes\n");
+
+    for (bi = 0; bits[bi] != 0; bi++) /* validation: */
+    {
+        unsigned int k = bits[bi], nl = k / 64, nopt = 0, ni;
+        unsigned int nv[6];
+        double emin = HUGE_VAL;
+
+        for (i = 0; i <= TD_PRIMES; i++)
+        {
+            double e = td_model(k, i, cd, cm[bi]);
+            if (e < emin) emin = e, nopt = i;
+        }
+
+        nv[0] = 54, nv[1] = nopt / 4, nv[2] = nopt / 2, nv[3] = nopt;
+        nv[4] = (2 * nopt < TD_PRIMES) ? 2 * nopt : TD_PRIMES;
+        nv[5] = (4 * nopt < TD_PRIMES) ? 4 * nopt : TD_PRIMES;
+
+        for (i = 0; i < NCAND; i++)
+            rng_cand(& seed, cand[i], nl);
+
+        for (ni = 0; ni < 6; ni++)
+        {
+            unsigned int np = 0, reps = 2048 / k, r;
+
+            for (c0 = clock(), r = 0; r < reps; r++)
+                for (i = 0; i < NCAND; i++)
+                    if (td_test(cand[i], nl, nv[ni]))
+                        mp_init(& m, cand[i], nl), np += mp_sprp(& m, 2, nl);
+
+            fprintf(stdout, "%5u : %4u%s: %10.1f  %11.1f  %6u\n", k,
+                    nv[ni], (ni == 3) ? "*" : " ",
+                    td_model(k, nv[ni], cd, cm[bi]) * 1e-6,
+                    (double) (clock() - c0) * 1e6 / CLOCKS_PER_SEC / np,
+                    np / reps);
+        }
+    }
+
+    return (0);
+}
+
+/******************************************************************************/